@@ -0,0 +1,40 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "abdada.h"
+
+namespace stoat {
+    bool SearchingTable::isSearching(u64 key, Move move) const {
+        const auto entryTag = tag(key, move);
+        return m_entries[index(entryTag)].load(std::memory_order::relaxed) == entryTag;
+    }
+
+    SearchingTable::Claim SearchingTable::claim(u64 key, Move move) {
+        const auto entryTag = tag(key, move);
+        auto& entry = m_entries[index(entryTag)];
+
+        u64 expected = 0;
+
+        if (!entry.compare_exchange_strong(expected, entryTag, std::memory_order::relaxed)) {
+            return {};
+        }
+
+        return {&entry, entryTag};
+    }
+} // namespace stoat
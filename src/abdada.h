@@ -0,0 +1,76 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "types.h"
+
+#include <array>
+#include <atomic>
+
+#include "move.h"
+
+namespace stoat {
+    // abdada-style record of the moves other threads are currently searching, so
+    // that a thread reaching the same node can try something else first. lossy -
+    // a move that collides with one already being searched just goes unrecorded
+    class SearchingTable {
+    public:
+        class Claim {
+        public:
+            Claim() = default;
+
+            inline Claim(std::atomic<u64>* entry, u64 tag) :
+                    m_entry{entry}, m_tag{tag} {}
+
+            Claim(const Claim&) = delete;
+            Claim(Claim&&) = delete;
+
+            inline ~Claim() {
+                if (m_entry) {
+                    auto tag = m_tag;
+                    m_entry->compare_exchange_strong(tag, 0, std::memory_order::relaxed);
+                }
+            }
+
+        private:
+            std::atomic<u64>* m_entry{};
+            u64 m_tag{};
+        };
+
+        [[nodiscard]] bool isSearching(u64 key, Move move) const;
+
+        // marks a move as being searched until the returned claim is destroyed
+        [[nodiscard]] Claim claim(u64 key, Move move);
+
+    private:
+        static constexpr usize kEntries = 32768;
+
+        [[nodiscard]] static inline u64 tag(u64 key, Move move) {
+            // never 0, which marks an empty entry
+            return (key ^ (static_cast<u64>(move.raw()) * 0x9E3779B97F4A7C15)) | 1;
+        }
+
+        [[nodiscard]] static inline usize index(u64 tag) {
+            return static_cast<usize>(tag >> 32) % kEntries;
+        }
+
+        std::array<std::atomic<u64>, kEntries> m_entries{};
+    };
+} // namespace stoat
@@ -29,6 +29,13 @@
     #else
         #define ST_HAS_FAST_PEXT 0
     #endif
+
+    // slider attack backend when pext is unavailable or slow
+    #if !ST_HAS_FAST_PEXT && !defined(ST_BYTE_REVERSE)
+        #define ST_USE_BLACK_MAGIC 1
+    #else
+        #define ST_USE_BLACK_MAGIC 0
+    #endif
 #else //TODO others
     #error no arch specified
 #endif
@@ -28,8 +28,10 @@
 
 #if ST_HAS_FAST_PEXT
     #include "sliders/bmi2.h"
-#else
+#elif ST_USE_BLACK_MAGIC
     #include "sliders/black_magic.h"
+#else
+    #include "sliders/byte_reverse.h"
 #endif
 
 namespace stoat::attacks {
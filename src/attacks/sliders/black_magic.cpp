@@ -18,7 +18,7 @@
 
 #include "../../arch.h"
 
-#if !ST_HAS_FAST_PEXT
+#if ST_USE_BLACK_MAGIC
     #include "black_magic.h"
 
 namespace stoat::attacks::sliders::black_magic {
@@ -0,0 +1,154 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../../types.h"
+
+#include <array>
+
+#include "../../core.h"
+#include "../../util/bits.h"
+#include "../../util/multi_array.h"
+#include "util.h"
+
+// pext-free slider attacks with small tables. rays towards higher squares are found by subtracting
+// one from the blockers on the ray, which sets every bit up to and including the nearest blocker.
+// along files and diagonals each square is in a different byte, so byte swapping the board reverses
+// their order and the same trick works for rays towards lower squares. ranks are looked up instead
+namespace stoat::attacks::sliders {
+    namespace byte_reverse {
+        struct LineMasks {
+            // byte swapped
+            u128 lower;
+            u128 upper;
+        };
+
+        template <i32 kLowerDir, i32 kUpperDir>
+        consteval std::array<LineMasks, Squares::kCount> generateLineMasks() {
+            static_assert(kLowerDir <= 0 && kUpperDir >= 0);
+
+            std::array<LineMasks, Squares::kCount> dst{};
+
+            for (i32 sqIdx = 0; sqIdx < Squares::kCount; ++sqIdx) {
+                const auto sq = Square::fromRaw(sqIdx);
+
+                if constexpr (kLowerDir != 0) {
+                    const auto ray = internal::generateSlidingAttacks(sq, kLowerDir, Bitboards::kEmpty);
+                    dst[sq.idx()].lower = util::byteswap(ray.raw());
+                }
+
+                if constexpr (kUpperDir != 0) {
+                    dst[sq.idx()].upper = internal::generateSlidingAttacks(sq, kUpperDir, Bitboards::kEmpty).raw();
+                }
+            }
+
+            return dst;
+        }
+
+        // attacks along a rank, indexed by file and the occupancy of the 7 inner squares of the rank
+        consteval util::MultiArray<u16, 9, 128> generateRankAttacks() {
+            util::MultiArray<u16, 9, 128> dst{};
+
+            for (i32 file = 0; file < 9; ++file) {
+                for (u32 inner = 0; inner < 128; ++inner) {
+                    const u32 occ = inner << 1;
+
+                    for (i32 to = file + 1; to < 9; ++to) {
+                        dst[file][inner] |= 1 << to;
+                        if ((occ >> to) & 1) {
+                            break;
+                        }
+                    }
+
+                    for (i32 to = file - 1; to >= 0; --to) {
+                        dst[file][inner] |= 1 << to;
+                        if ((occ >> to) & 1) {
+                            break;
+                        }
+                    }
+                }
+            }
+
+            return dst;
+        }
+
+        inline constexpr util::MultiArray<LineMasks, Colors::kCount, Squares::kCount> kLanceMasks = {
+            generateLineMasks<0, offsets::kNorth>(), // black
+            generateLineMasks<offsets::kSouth, 0>(), // white
+        };
+
+        inline constexpr util::MultiArray<LineMasks, 2, Squares::kCount> kBishopMasks = {
+            generateLineMasks<offsets::kSouthEast, offsets::kNorthWest>(),
+            generateLineMasks<offsets::kSouthWest, offsets::kNorthEast>(),
+        };
+
+        inline constexpr auto kFileMasks = generateLineMasks<offsets::kSouth, offsets::kNorth>();
+
+        inline constexpr auto kRankAttacks = generateRankAttacks();
+
+        [[nodiscard]] inline u128 upperAttacks(u128 occ, u128 mask) {
+            const auto blockers = occ & mask;
+            return (blockers ^ (blockers - 1)) & mask;
+        }
+
+        [[nodiscard]] inline u128 lowerAttacks(u128 swappedOcc, u128 swappedMask) {
+            return util::byteswap(upperAttacks(swappedOcc, swappedMask));
+        }
+
+        [[nodiscard]] inline u128 lineAttacks(u128 occ, u128 swappedOcc, const LineMasks& masks) {
+            return upperAttacks(occ, masks.upper) | lowerAttacks(swappedOcc, masks.lower);
+        }
+
+        [[nodiscard]] inline u128 rankAttacks(Square sq, u128 occ) {
+            const auto shift = sq.rank() * 9;
+            const auto inner = static_cast<u32>(occ >> (shift + 1)) & 0x7F;
+            return static_cast<u128>(kRankAttacks[sq.file()][inner]) << shift;
+        }
+    } // namespace byte_reverse
+
+    [[nodiscard]] inline Bitboard lanceAttacks(Square sq, Color c, Bitboard occ) {
+        const auto& masks = byte_reverse::kLanceMasks[c.idx()][sq.idx()];
+
+        if (c == Colors::kBlack) {
+            return Bitboard{byte_reverse::upperAttacks(occ.raw(), masks.upper)};
+        } else {
+            return Bitboard{byte_reverse::lowerAttacks(util::byteswap(occ.raw()), masks.lower)};
+        }
+    }
+
+    [[nodiscard]] inline Bitboard bishopAttacks(Square sq, Bitboard occ) {
+        const auto swappedOcc = util::byteswap(occ.raw());
+
+        const auto& masks = byte_reverse::kBishopMasks;
+        return Bitboard{
+            byte_reverse::lineAttacks(occ.raw(), swappedOcc, masks[0][sq.idx()])
+            | byte_reverse::lineAttacks(occ.raw(), swappedOcc, masks[1][sq.idx()])
+        };
+    }
+
+    [[nodiscard]] inline Bitboard rookAttacks(Square sq, Bitboard occ) {
+        const auto swappedOcc = util::byteswap(occ.raw());
+
+        const auto& masks = byte_reverse::kFileMasks[sq.idx()];
+        return Bitboard{
+            byte_reverse::lineAttacks(occ.raw(), swappedOcc, masks) | byte_reverse::rankAttacks(sq, occ.raw())
+        };
+    }
+} // namespace stoat::attacks::sliders
@@ -18,12 +18,23 @@
 
 #include "bench.h"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
 #include <string_view>
+#include <vector>
+
+#include <fmt/ranges.h>
 
 #include "position.h"
 #include "search.h"
 #include "stats.h"
+#include "util/json.h"
+#include "util/perf_counters.h"
 
 namespace stoat::bench {
     namespace {
@@ -39,35 +50,577 @@ namespace stoat::bench {
             "l6nl/5+P1gk/2np1S3/p1p4Pp/3P2Sp1/1PPb2P1P/P5GS1/R8/LN4bKL w RGgsn5p 1"sv,
         };
 
-        constexpr usize kTtSizeMib = 16;
+        // two-sided 95% critical values of student's t distribution, by degrees of freedom
+        constexpr std::array kTCriticalValues = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+        };
+
+        struct BenchTotals {
+            usize nodes{};
+            usize duplicateNodes{};
+            f64 time{};
+
+            std::vector<BenchInfo> positions{};
+        };
+
+        BenchTotals runPositions(
+            const BenchConfig& config,
+            u32 threads,
+            std::span<const std::string> sfens,
+            util::PerfCounters* counters,
+            bool verbose = true
+        ) {
+            Searcher searcher{config.ttSizeMib};
+
+            searcher.setSilent(!verbose);
+            searcher.setThreadCount(threads);
+            searcher.setAbdada(config.abdada);
+            searcher.setTrackDuplicates(true);
+
+            searcher.ensureReady();
+
+            BenchTotals totals{};
+
+            for (const auto& sfen : sfens) {
+                if (verbose) {
+                    fmt::println("SFEN: {}", sfen);
+                }
+
+                const auto pos = Position::fromSfen(sfen).take();
+
+                BenchInfo info{};
+
+                if (counters) {
+                    counters->start();
+                }
+
+                searcher.runBenchSearch(info, pos, config.depth);
+
+                if (counters) {
+                    counters->stop();
+                }
+
+                totals.nodes += info.nodes;
+                totals.duplicateNodes += info.duplicateNodes;
+                totals.time += info.time;
+
+                totals.positions.push_back(info);
+
+                if (verbose) {
+                    fmt::println("");
+                }
+            }
+
+            return totals;
+        }
+
+        [[nodiscard]] usize nps(usize nodes, f64 time) {
+            return static_cast<usize>(static_cast<f64>(nodes) / time);
+        }
+
+        [[nodiscard]] usize nps(const BenchTotals& totals) {
+            return nps(totals.nodes, totals.time);
+        }
+
+        struct Baseline {
+            BenchConfig config{};
+
+            std::vector<std::string> sfens{};
+            std::vector<usize> nodes{};
+            // [position][repetition]
+            std::vector<std::vector<f64>> nps{};
+
+            usize totalNodes{};
+            std::vector<f64> totalNps{};
+        };
+
+        std::optional<Baseline> loadBaseline(std::string_view path) {
+            std::ifstream stream{std::string{path}};
+
+            if (!stream) {
+                fmt::println(stderr, "failed to open baseline \"{}\"", path);
+                return {};
+            }
+
+            const std::string text{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+
+            const auto invalid = [&] {
+                fmt::println(stderr, "invalid bench json in {}", path);
+                return std::nullopt;
+            };
+
+            const auto json = util::json::parse(text);
+
+            if (!json) {
+                return invalid();
+            }
+
+            const auto number = [](const util::json::Value& parent, std::string_view key) -> std::optional<f64> {
+                const auto* value = parent.find(key);
+                return value ? value->number() : std::nullopt;
+            };
+
+            // a single number is a baseline with one repetition
+            const auto samples = [](const util::json::Value& parent,
+                                    std::string_view key) -> std::optional<std::vector<f64>> {
+                const auto* value = parent.find(key);
+
+                if (!value) {
+                    return {};
+                }
+
+                if (const auto single = value->number()) {
+                    return std::vector{*single};
+                }
+
+                if (!value->array() || value->array()->empty()) {
+                    return {};
+                }
+
+                std::vector<f64> dst{};
+
+                for (const auto& sample : *value->array()) {
+                    if (!sample.number()) {
+                        return {};
+                    }
+
+                    dst.push_back(*sample.number());
+                }
+
+                return dst;
+            };
+
+            Baseline baseline{};
+
+            const auto depth = number(*json, "depth");
+            const auto threads = number(*json, "threads");
+            const auto hash = number(*json, "hash");
+            const auto* abdada = json->find("abdada");
+            const auto* positions = json->find("positions");
+
+            if (!depth || !threads || !hash || !abdada || !abdada->boolean() || !positions || !positions->array()) {
+                return invalid();
+            }
+
+            baseline.config.depth = static_cast<i32>(*depth);
+            baseline.config.threads = kThreadCountRange.clamp(static_cast<u32>(*threads));
+            baseline.config.ttSizeMib = tt::kTtSizeRange.clamp(static_cast<usize>(*hash));
+            baseline.config.abdada = *abdada->boolean();
+
+            for (const auto& position : *positions->array()) {
+                const auto* sfen = position.find("sfen");
+                const auto nodes = number(position, "nodes");
+                auto positionNps = samples(position, "nps");
+
+                if (!sfen || !sfen->string() || !nodes || !positionNps || !Position::fromSfen(*sfen->string())) {
+                    return invalid();
+                }
+
+                baseline.sfens.push_back(*sfen->string());
+                baseline.nodes.push_back(static_cast<usize>(*nodes));
+                baseline.nps.push_back(std::move(*positionNps));
+            }
+
+            const auto totalNodes = number(*json, "nodes");
+            auto totalNps = samples(*json, "nps");
+
+            if (baseline.sfens.empty() || !totalNodes || !totalNps) {
+                return invalid();
+            }
+
+            baseline.totalNodes = static_cast<usize>(*totalNodes);
+            baseline.totalNps = std::move(*totalNps);
+
+            return baseline;
+        }
+
+        [[nodiscard]] f64 tCriticalValue(f64 df) {
+            // rounding down is conservative
+            const auto idx = static_cast<usize>(std::max(df, 1.0));
+            return idx <= kTCriticalValues.size() ? kTCriticalValues[idx - 1] : 1.960;
+        }
+
+        [[nodiscard]] f64 mean(std::span<const f64> samples) {
+            f64 sum{};
+            for (const auto sample : samples) {
+                sum += sample;
+            }
+            return sum / static_cast<f64>(samples.size());
+        }
+
+        // sample variance, samples.size() must be at least 2
+        [[nodiscard]] f64 variance(std::span<const f64> samples) {
+            const auto m = mean(samples);
+
+            f64 sum{};
+            for (const auto sample : samples) {
+                sum += (sample - m) * (sample - m);
+            }
+            return sum / static_cast<f64>(samples.size() - 1);
+        }
+
+        struct Interval {
+            f64 mean;
+            // half the width of the 95% confidence interval
+            f64 error;
+        };
+
+        // welch's t interval on curr - base. the runs being compared are independent and
+        // need not share a variance, which a fresh build on a different day will not.
+        // nothing if either side has fewer than two samples
+        [[nodiscard]] std::optional<Interval> differenceInterval(
+            std::span<const f64> base,
+            std::span<const f64> curr
+        ) {
+            if (base.size() < 2 || curr.size() < 2) {
+                return {};
+            }
+
+            const auto baseN = static_cast<f64>(base.size());
+            const auto currN = static_cast<f64>(curr.size());
+
+            const auto baseTerm = variance(base) / baseN;
+            const auto currTerm = variance(curr) / currN;
+
+            const auto stdErr = std::sqrt(baseTerm + currTerm);
+
+            // welch-satterthwaite
+            const auto dfDenom = baseTerm * baseTerm / (baseN - 1.0) + currTerm * currTerm / (currN - 1.0);
+            const auto df = dfDenom > 0.0 ? (baseTerm + currTerm) * (baseTerm + currTerm) / dfDenom : baseN + currN - 2.0;
+
+            return Interval{mean(curr) - mean(base), tCriticalValue(df) * stdErr};
+        }
     } // namespace
 
-    void run(i32 depth) {
-        Searcher searcher{kTtSizeMib};
-        searcher.ensureReady();
+    std::optional<std::vector<std::string>> loadSfens(std::string_view path) {
+        std::vector<std::string> sfens{};
 
-        usize totalNodes{};
-        f64 totalTime{};
+        if (path.empty()) {
+            sfens.assign(kBenchSfens.begin(), kBenchSfens.end());
+            return sfens;
+        }
 
-        for (const auto sfen : kBenchSfens) {
-            fmt::println("SFEN: {}", sfen);
+        std::ifstream stream{std::string{path}};
 
-            const auto pos = Position::fromSfen(sfen).take();
+        if (!stream) {
+            fmt::println(stderr, "failed to open sfen file \"{}\"", path);
+            return {};
+        }
 
-            BenchInfo info{};
-            searcher.runBenchSearch(info, pos, depth);
+        for (std::string line{}; std::getline(stream, line);) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
 
-            totalNodes += info.nodes;
-            totalTime += info.time;
+            if (line.empty() || line.starts_with('#')) {
+                continue;
+            }
 
-            fmt::println("");
+            if (const auto pos = Position::fromSfen(line); !pos) {
+                fmt::println(stderr, "invalid sfen \"{}\" in {}", line, path);
+                return {};
+            }
+
+            sfens.push_back(std::move(line));
+        }
+
+        if (sfens.empty()) {
+            fmt::println(stderr, "no sfens in {}", path);
+            return {};
+        }
+
+        return sfens;
+    }
+
+    bool run(const BenchConfig& config) {
+        const auto sfens = loadSfens(config.sfenFile);
+
+        if (!sfens) {
+            return false;
         }
 
-        const auto nps = static_cast<usize>(static_cast<f64>(totalNodes) / totalTime);
+        // opened before the searcher creates its threads, so that they are counted too
+        util::PerfCounters counters{};
+
+        const auto totals = runPositions(config, config.threads, *sfens, &counters);
+
+        fmt::println("{:.5g} seconds", totals.time);
+        fmt::println("{} nodes {} nps", totals.nodes, nps(totals));
 
-        fmt::println("{:.5g} seconds", totalTime);
-        fmt::println("{} nodes {} nps", totalNodes, nps);
+        if (config.threads > 1) {
+            const auto duplicatePercent = static_cast<f64>(totals.duplicateNodes)
+                                        / static_cast<f64>(std::max<usize>(totals.nodes, 1)) * 100.0;
+            fmt::println("{} duplicate nodes ({:.3g}%)", totals.duplicateNodes, duplicatePercent);
+        }
+
+        counters.print(totals.nodes);
 
         stats::print();
+
+        return true;
+    }
+
+    bool runScaling(const BenchConfig& config) {
+        const auto sfens = loadSfens(config.sfenFile);
+
+        if (!sfens) {
+            return false;
+        }
+
+        std::vector<u32> threadCounts{};
+
+        for (u32 threads = 1; threads < config.threads; threads *= 2) {
+            threadCounts.push_back(threads);
+        }
+
+        threadCounts.push_back(config.threads);
+
+        std::vector<BenchTotals> results{};
+
+        for (const auto threads : threadCounts) {
+            fmt::println("threads: {}", threads);
+            fmt::println("");
+
+            results.push_back(runPositions(config, threads, *sfens, nullptr));
+        }
+
+        const auto& baseline = results[0];
+
+        fmt::println(
+            "{:>8} {:>14} {:>10} {:>12} {:>12} {:>12} {:>11}",
+            "threads",
+            "nodes",
+            "seconds",
+            "nps",
+            "nps speedup",
+            "ttd speedup",
+            "duplicates"
+        );
+
+        for (usize idx = 0; idx < results.size(); ++idx) {
+            const auto& totals = results[idx];
+
+            const auto npsSpeedup = static_cast<f64>(nps(totals)) / static_cast<f64>(std::max<usize>(nps(baseline), 1));
+            // every thread count searches the same positions to the same depth
+            const auto ttdSpeedup = baseline.time / totals.time;
+            const auto duplicatePercent = static_cast<f64>(totals.duplicateNodes)
+                                        / static_cast<f64>(std::max<usize>(totals.nodes, 1)) * 100.0;
+
+            fmt::println(
+                "{:>8} {:>14} {:>10.3f} {:>12} {:>11.3f}x {:>11.3f}x {:>10.2f}%",
+                threadCounts[idx],
+                totals.nodes,
+                totals.time,
+                nps(totals),
+                npsSpeedup,
+                ttdSpeedup,
+                duplicatePercent
+            );
+        }
+
+        return true;
+    }
+
+    bool runJson(const BenchConfig& config, u32 repetitions) {
+        const auto sfens = loadSfens(config.sfenFile);
+
+        if (!sfens) {
+            return false;
+        }
+
+        repetitions = std::max<u32>(repetitions, 1);
+
+        // [position][repetition]
+        std::vector<std::vector<f64>> positionNps(sfens->size());
+        std::vector<f64> totalNps{};
+
+        BenchTotals first{};
+
+        for (u32 repetition = 0; repetition < repetitions; ++repetition) {
+            auto totals = runPositions(config, config.threads, *sfens, nullptr, false);
+
+            for (usize idx = 0; idx < sfens->size(); ++idx) {
+                const auto& info = totals.positions[idx];
+                positionNps[idx].push_back(static_cast<f64>(nps(info.nodes, info.time)));
+            }
+
+            totalNps.push_back(static_cast<f64>(nps(totals)));
+
+            if (repetition == 0) {
+                first = std::move(totals);
+            }
+        }
+
+        std::string json{};
+        auto itr = std::back_inserter(json);
+
+        fmt::format_to(
+            itr,
+            R"({{"depth":{},"threads":{},"abdada":{},"hash":{},"repetitions":{},"positions":[)",
+            config.depth,
+            config.threads,
+            config.abdada,
+            config.ttSizeMib,
+            repetitions
+        );
+
+        // nodes are from the first repetition, they only vary between repetitions with smp
+        for (usize idx = 0; idx < sfens->size(); ++idx) {
+            fmt::format_to(
+                itr,
+                R"({}{{"sfen":"{}","nodes":{},"nps":[{:.0f}]}})",
+                idx == 0 ? "" : ",",
+                (*sfens)[idx],
+                first.positions[idx].nodes,
+                fmt::join(positionNps[idx], ",")
+            );
+        }
+
+        fmt::format_to(itr, R"(],"nodes":{},"nps":[{:.0f}]}})", first.nodes, fmt::join(totalNps, ","));
+
+        fmt::println("{}", json);
+
+        return true;
+    }
+
+    bool runCompare(std::string_view baselinePath, u32 repetitions) {
+        const auto baseline = loadBaseline(baselinePath);
+
+        if (!baseline) {
+            return false;
+        }
+
+        repetitions = std::max<u32>(repetitions, 2);
+
+        const auto& config = baseline->config;
+        const auto positionCount = baseline->sfens.size();
+
+        fmt::println(
+            "depth {}, {} threads, abdada {}, {} MiB hash, {} positions, {} baseline and {} new repetitions",
+            config.depth,
+            config.threads,
+            config.abdada,
+            config.ttSizeMib,
+            positionCount,
+            baseline->totalNps.size(),
+            repetitions
+        );
+
+        // [position][repetition]
+        std::vector<std::vector<f64>> positionNps(positionCount);
+        std::vector<f64> totalNps{};
+
+        std::vector<usize> nodes{};
+        bool nodesStable = true;
+
+        for (u32 repetition = 0; repetition < repetitions; ++repetition) {
+            const auto totals = runPositions(config, config.threads, baseline->sfens, nullptr, false);
+
+            for (usize idx = 0; idx < positionCount; ++idx) {
+                const auto& info = totals.positions[idx];
+                positionNps[idx].push_back(static_cast<f64>(nps(info.nodes, info.time)));
+
+                if (repetition == 0) {
+                    nodes.push_back(info.nodes);
+                } else if (info.nodes != nodes[idx]) {
+                    nodesStable = false;
+                }
+            }
+
+            totalNps.push_back(static_cast<f64>(nps(totals)));
+
+            fmt::println("repetition {}: {} nps", repetition + 1, nps(totals));
+        }
+
+        // as a percentage of the baseline's mean nps
+        const auto formatDelta = [](std::span<const f64> base, std::span<const f64> curr) {
+            const auto baseMean = mean(base);
+            const auto delta = (mean(curr) / baseMean - 1.0) * 100.0;
+
+            if (const auto interval = differenceInterval(base, curr)) {
+                return fmt::format("{:+.2f}% +- {:.2f}%", delta, interval->error / baseMean * 100.0);
+            }
+
+            return fmt::format("{:+.2f}% +- ?", delta);
+        };
+
+        const auto printDelta = [&](std::string_view label,
+                                    usize baseNodes,
+                                    usize newNodes,
+                                    std::span<const f64> base,
+                                    std::span<const f64> curr) {
+            fmt::println(
+                "{:>6} {:>14} {:>14} {:>12.0f} {:>12.0f} {:>18}{}",
+                label,
+                baseNodes,
+                newNodes,
+                mean(base),
+                mean(curr),
+                formatDelta(base, curr),
+                baseNodes == newNodes ? "" : "  nodes changed"
+            );
+        };
+
+        fmt::println("");
+        fmt::println(
+            "{:>6} {:>14} {:>14} {:>12} {:>12} {:>18}",
+            "pos",
+            "base nodes",
+            "nodes",
+            "base nps",
+            "nps",
+            "delta"
+        );
+
+        usize changedPositions{};
+        usize totalNodes{};
+
+        for (usize idx = 0; idx < positionCount; ++idx) {
+            const auto label = fmt::format("{}", idx + 1);
+
+            printDelta(label, baseline->nodes[idx], nodes[idx], baseline->nps[idx], positionNps[idx]);
+
+            changedPositions += nodes[idx] != baseline->nodes[idx];
+            totalNodes += nodes[idx];
+        }
+
+        printDelta("total", baseline->totalNodes, totalNodes, baseline->totalNps, totalNps);
+
+        fmt::println("");
+
+        bool passed = true;
+
+        // smp searches are not deterministic, so differing node counts mean nothing there
+        if (config.threads > 1 || !nodesStable) {
+            fmt::println("node counts: not deterministic with these settings, not compared");
+        } else if (changedPositions > 0) {
+            fmt::println(
+                "node counts: CHANGED in {} of {} positions, this is a functional change",
+                changedPositions,
+                positionCount
+            );
+            passed = false;
+        } else {
+            fmt::println("node counts: match the baseline");
+        }
+
+        const auto total = differenceInterval(baseline->totalNps, totalNps);
+        const auto delta = formatDelta(baseline->totalNps, totalNps);
+
+        // only a difference whose interval excludes zero fails the comparison
+        if (!total) {
+            fmt::println("speed: {}, baseline has a single repetition, not compared", delta);
+        } else if (total->mean - total->error > 0.0) {
+            fmt::println("speed: {}, faster", delta);
+        } else if (total->mean + total->error < 0.0) {
+            fmt::println("speed: {}, SLOWER", delta);
+            passed = false;
+        } else {
+            fmt::println("speed: {}, no significant change", delta);
+        }
+
+        return passed;
     }
 } // namespace stoat::bench
@@ -20,7 +20,44 @@
 
 #include "types.h"
 
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace stoat::bench {
     constexpr i32 kDefaultBenchDepth = 14;
-    void run(i32 depth = kDefaultBenchDepth);
+    constexpr u32 kDefaultBenchThreads = 1;
+    constexpr usize kDefaultBenchTtSizeMib = 16;
+
+    constexpr u32 kDefaultCompareRepetitions = 5;
+
+    struct BenchConfig {
+        i32 depth{kDefaultBenchDepth};
+        u32 threads{kDefaultBenchThreads};
+        bool abdada{false};
+        usize ttSizeMib{kDefaultBenchTtSizeMib};
+        // one sfen per line, the built-in positions if empty
+        std::string sfenFile{};
+    };
+
+    // the built-in bench positions if path is empty, otherwise one sfen per line from
+    // the file, skipping blank lines and # comments. prints an error and returns nothing if any are invalid
+    [[nodiscard]] std::optional<std::vector<std::string>> loadSfens(std::string_view path);
+
+    // false if the sfen file could not be loaded
+    bool run(const BenchConfig& config = {});
+
+    // runs the bench at 1, 2, 4... threads up to config.threads,
+    // then reports nps and time to depth speedups over a single thread
+    bool runScaling(const BenchConfig& config = {});
+
+    // as run repeated the given number of times, but without search output, finishing with a
+    // single line of json holding the settings, each position's nodes and every nps sample
+    bool runJson(const BenchConfig& config = {}, u32 repetitions = kDefaultCompareRepetitions);
+
+    // reruns a bench saved from runJson with the same settings and positions, and reports nps
+    // deltas with 95% confidence intervals on the difference. false if node counts changed, meaning
+    // a functional change, or if the bench was slower by more than the noise in both sets of runs
+    bool runCompare(std::string_view baselinePath, u32 repetitions = kDefaultCompareRepetitions);
 } // namespace stoat::bench
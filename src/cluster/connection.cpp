@@ -0,0 +1,91 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "connection.h"
+
+#include <array>
+#include <cassert>
+#include <cstring>
+
+namespace stoat::cluster {
+    namespace {
+        // u32 payload size, then u8 message type
+        constexpr usize kHeaderSize = sizeof(u32) + sizeof(u8);
+    } // namespace
+
+    Connection::Connection(Socket socket) :
+            m_socket{std::move(socket)} {}
+
+    bool Connection::send(MessageType type, std::span<const u8> payload) {
+        if (!isOpen()) {
+            return false;
+        }
+
+        assert(payload.size() <= kMaxPayloadSize);
+
+        std::array<u8, kHeaderSize> header{};
+
+        const auto size = static_cast<u32>(payload.size());
+        std::memcpy(header.data(), &size, sizeof(u32));
+        header[sizeof(u32)] = static_cast<u8>(type);
+
+        const std::unique_lock lock{m_sendMutex};
+
+        if (!m_socket.sendAll(header) || !m_socket.sendAll(payload)) {
+            m_open.store(false, std::memory_order::relaxed);
+            return false;
+        }
+
+        return true;
+    }
+
+    std::optional<Message> Connection::receive(i32 timeoutMs) {
+        if (!isOpen() || !m_socket.waitReadable(timeoutMs)) {
+            return {};
+        }
+
+        std::array<u8, kHeaderSize> header{};
+
+        if (!m_socket.recvAll(header)) {
+            m_open.store(false, std::memory_order::relaxed);
+            return {};
+        }
+
+        u32 size{};
+        std::memcpy(&size, header.data(), sizeof(u32));
+
+        if (size > kMaxPayloadSize || header[sizeof(u32)] > static_cast<u8>(MessageType::kTtEntries)) {
+            fmt::println(stderr, "Invalid cluster message header, dropping connection");
+            m_open.store(false, std::memory_order::relaxed);
+            return {};
+        }
+
+        Message message{};
+
+        message.type = static_cast<MessageType>(header[sizeof(u32)]);
+        message.payload.resize(size);
+
+        if (!m_socket.recvAll(message.payload)) {
+            m_open.store(false, std::memory_order::relaxed);
+            return {};
+        }
+
+        return message;
+    }
+} // namespace stoat::cluster
@@ -0,0 +1,71 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../types.h"
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "socket.h"
+
+namespace stoat::cluster {
+    enum class MessageType : u8 {
+        // coordinator -> worker
+        kSearch = 0,
+        kStop,
+        // worker -> coordinator
+        kInfo,
+        // both ways
+        kTtEntries,
+    };
+
+    struct Message {
+        MessageType type{};
+        std::vector<u8> payload{};
+    };
+
+    // length-prefixed messages over a socket. sending is thread safe,
+    // receiving is only done from one thread at a time
+    class Connection {
+    public:
+        explicit Connection(Socket socket);
+
+        bool send(MessageType type, std::span<const u8> payload);
+
+        // nullopt if no complete message arrived within the timeout, or if the connection was closed
+        [[nodiscard]] std::optional<Message> receive(i32 timeoutMs);
+
+        [[nodiscard]] inline bool isOpen() const {
+            return m_open.load(std::memory_order::relaxed);
+        }
+
+    private:
+        static constexpr u32 kMaxPayloadSize = 64 * 1024 * 1024;
+
+        Socket m_socket;
+        std::mutex m_sendMutex{};
+
+        std::atomic_bool m_open{true};
+    };
+} // namespace stoat::cluster
@@ -0,0 +1,182 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "coordinator.h"
+
+#include "../movegen.h"
+#include "../util/split.h"
+#include "../util/timer.h"
+#include "message.h"
+#include "worker.h"
+
+namespace stoat::cluster {
+    namespace {
+        constexpr f64 kTtShareInterval = 0.1;
+    } // namespace
+
+    Coordinator::Coordinator(Searcher& searcher) :
+            m_searcher{searcher} {}
+
+    Coordinator::~Coordinator() {
+        join();
+    }
+
+    void Coordinator::setWorkers(std::string_view addresses) {
+        join();
+
+        m_workers.clear();
+
+        std::vector<std::string_view> split{};
+        util::split(split, addresses, ',');
+
+        for (const auto address : split) {
+            if (address.empty()) {
+                continue;
+            }
+
+            if (auto socket = Socket::connect(address)) {
+                m_workers.push_back(std::make_unique<Connection>(std::move(*socket)));
+            }
+        }
+
+        m_searcher.setTtShareDepth(m_workers.empty() ? 0 : kTtShareDepth);
+    }
+
+    void Coordinator::prepareSearch() {
+        join();
+        m_finishedSearches = m_searcher.finishedSearches();
+    }
+
+    void Coordinator::startSearch(const Position& pos, std::span<const u64> keyHistory) {
+        join();
+
+        if (m_workers.empty()) {
+            return;
+        }
+
+        ++m_searchId;
+
+        movegen::MoveList generated{};
+        movegen::generateLegal(generated, pos);
+
+        std::vector<Move> rootMoves{generated.begin(), generated.end()};
+
+        if (rootMoves.empty()) {
+            return;
+        }
+
+        SearchRequest request{};
+
+        request.searchId = m_searchId;
+        request.sfen = pos.sfen();
+        request.keyHistory.assign(keyHistory.begin(), keyHistory.end());
+
+        for (u32 workerIdx = 0; workerIdx < m_workers.size(); ++workerIdx) {
+            request.rootMoves.clear();
+
+            for (u32 moveIdx = workerIdx; moveIdx < rootMoves.size(); moveIdx += m_workers.size()) {
+                request.rootMoves.push_back(rootMoves[moveIdx]);
+            }
+
+            // more workers than moves - double up
+            if (request.rootMoves.empty()) {
+                request.rootMoves.push_back(rootMoves[workerIdx % rootMoves.size()]);
+            }
+
+            m_workers[workerIdx]->send(MessageType::kSearch, encode(request));
+        }
+
+        m_thread = std::thread{[this] { run(); }};
+    }
+
+    void Coordinator::join() {
+        if (m_thread.joinable()) {
+            m_stop.store(true, std::memory_order::relaxed);
+            m_thread.join();
+        }
+
+        m_stop.store(false, std::memory_order::relaxed);
+    }
+
+    void Coordinator::run() {
+        std::vector<tt::SharedEntry> sharedEntries{};
+        auto lastShare = util::Instant::now();
+
+        // not isSearching, which may already be true again for the next search
+        while (!m_stop.load(std::memory_order::relaxed) && m_searcher.finishedSearches() == m_finishedSearches) {
+            for (u32 workerIdx = 0; workerIdx < m_workers.size(); ++workerIdx) {
+                while (const auto message = m_workers[workerIdx]->receive(0)) {
+                    handleMessage(workerIdx, *message);
+                }
+            }
+
+            if (lastShare.elapsed() >= kTtShareInterval) {
+                m_searcher.takeSharedTtEntries(sharedEntries);
+
+                if (!sharedEntries.empty()) {
+                    broadcast(MessageType::kTtEntries, encode(TtEntries{m_searchId, sharedEntries}));
+                }
+
+                lastShare = util::Instant::now();
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{kPollIntervalMs});
+        }
+
+        broadcast(MessageType::kStop, encode(StopRequest{m_searchId}));
+    }
+
+    void Coordinator::handleMessage(u32 workerIdx, const Message& message) {
+        switch (message.type) {
+            case MessageType::kInfo: {
+                LineReport report{};
+
+                if (decode(report, message.payload) && report.searchId == m_searchId) {
+                    m_searcher.reportExternalLine(workerIdx, report.depth, report.score, report.pv);
+                }
+
+                break;
+            }
+
+            case MessageType::kTtEntries: {
+                TtEntries entries{};
+
+                if (decode(entries, message.payload) && entries.searchId == m_searchId) {
+                    m_searcher.importTtEntries(entries.entries);
+                    // pass them on to everyone else
+                    broadcast(MessageType::kTtEntries, message.payload, workerIdx);
+                }
+
+                break;
+            }
+
+            default:
+                fmt::println(stderr, "Unexpected message type {} from worker", static_cast<u32>(message.type));
+                break;
+        }
+    }
+
+    void Coordinator::broadcast(MessageType type, std::span<const u8> payload, u32 excludedIdx) {
+        for (u32 workerIdx = 0; workerIdx < m_workers.size(); ++workerIdx) {
+            if (workerIdx != excludedIdx) {
+                m_workers[workerIdx]->send(type, payload);
+            }
+        }
+    }
+} // namespace stoat::cluster
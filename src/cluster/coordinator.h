@@ -0,0 +1,73 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../types.h"
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../position.h"
+#include "../search.h"
+#include "connection.h"
+
+namespace stoat::cluster {
+    // drives worker processes alongside the local searcher. the local search
+    // covers every root move while each worker searches its own share of them,
+    // and lines the workers find deeper than the local search are reported instead
+    class Coordinator {
+    public:
+        explicit Coordinator(Searcher& searcher);
+        ~Coordinator();
+
+        // comma separated worker addresses, or empty to leave cluster mode
+        void setWorkers(std::string_view addresses);
+
+        // to be called just before the local search is started. stops
+        // coordinating the previous search, if that is still going on
+        void prepareSearch();
+
+        // to be called just after the local search has been started
+        void startSearch(const Position& pos, std::span<const u64> keyHistory);
+
+    private:
+        Searcher& m_searcher;
+
+        std::vector<std::unique_ptr<Connection>> m_workers{};
+        std::thread m_thread{};
+        std::atomic_bool m_stop{};
+
+        u32 m_searchId{};
+
+        // the local search is over once the searcher has finished more searches than this
+        u32 m_finishedSearches{};
+
+        void join();
+
+        void run();
+        void handleMessage(u32 workerIdx, const Message& message);
+
+        void broadcast(MessageType type, std::span<const u8> payload, u32 excludedIdx = ~0U);
+    };
+} // namespace stoat::cluster
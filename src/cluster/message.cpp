@@ -0,0 +1,101 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "message.h"
+
+#include <algorithm>
+
+namespace stoat::cluster {
+    namespace {
+        [[nodiscard]] std::vector<u8> finish(const MessageWriter& writer) {
+            const auto data = writer.data();
+            return std::vector<u8>{data.begin(), data.end()};
+        }
+    } // namespace
+
+    std::vector<u8> encode(const SearchRequest& msg) {
+        MessageWriter writer{};
+
+        writer.write(msg.searchId);
+        writer.writeString(msg.sfen);
+        writer.writeSpan(std::span{msg.keyHistory});
+        writer.writeSpan(std::span{msg.rootMoves});
+
+        return finish(writer);
+    }
+
+    std::vector<u8> encode(const StopRequest& msg) {
+        MessageWriter writer{};
+        writer.write(msg.searchId);
+        return finish(writer);
+    }
+
+    std::vector<u8> encode(const LineReport& msg) {
+        MessageWriter writer{};
+
+        writer.write(msg.searchId);
+        writer.write(msg.depth);
+        writer.write(msg.score);
+        writer.writeSpan(std::span{msg.pv.moves.data(), msg.pv.length});
+
+        return finish(writer);
+    }
+
+    std::vector<u8> encode(const TtEntries& msg) {
+        MessageWriter writer{};
+
+        writer.write(msg.searchId);
+        writer.writeSpan(std::span{msg.entries});
+
+        return finish(writer);
+    }
+
+    bool decode(SearchRequest& dst, std::span<const u8> payload) {
+        MessageReader reader{payload};
+        return reader.read(dst.searchId) && reader.readString(dst.sfen) && reader.readVector(dst.keyHistory)
+            && reader.readVector(dst.rootMoves);
+    }
+
+    bool decode(StopRequest& dst, std::span<const u8> payload) {
+        MessageReader reader{payload};
+        return reader.read(dst.searchId);
+    }
+
+    bool decode(LineReport& dst, std::span<const u8> payload) {
+        MessageReader reader{payload};
+
+        std::vector<Move> pv{};
+
+        if (!reader.read(dst.searchId) || !reader.read(dst.depth) || !reader.read(dst.score)
+            || !reader.readVector(pv) || pv.empty() || pv.size() > dst.pv.moves.size())
+        {
+            return false;
+        }
+
+        std::ranges::copy(pv, dst.pv.moves.begin());
+        dst.pv.length = pv.size();
+
+        return true;
+    }
+
+    bool decode(TtEntries& dst, std::span<const u8> payload) {
+        MessageReader reader{payload};
+        return reader.read(dst.searchId) && reader.readVector(dst.entries);
+    }
+} // namespace stoat::cluster
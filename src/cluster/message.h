@@ -0,0 +1,160 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../types.h"
+
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../core.h"
+#include "../move.h"
+#include "../pv.h"
+#include "../ttable.h"
+
+namespace stoat::cluster {
+    // values are copied as-is, so every process in a cluster must run the same build
+    class MessageWriter {
+    public:
+        template <typename T>
+        inline void write(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            const auto offset = m_data.size();
+            m_data.resize(offset + sizeof(T));
+
+            std::memcpy(m_data.data() + offset, &value, sizeof(T));
+        }
+
+        template <typename T>
+        inline void writeSpan(std::span<const T> values) {
+            write(static_cast<u32>(values.size()));
+
+            for (const auto& value : values) {
+                write(value);
+            }
+        }
+
+        inline void writeString(std::string_view str) {
+            writeSpan(std::span{str.data(), str.size()});
+        }
+
+        [[nodiscard]] inline std::span<const u8> data() const {
+            return m_data;
+        }
+
+    private:
+        std::vector<u8> m_data{};
+    };
+
+    class MessageReader {
+    public:
+        explicit inline MessageReader(std::span<const u8> data) :
+                m_data{data} {}
+
+        template <typename T>
+        [[nodiscard]] inline bool read(T& dst) {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            if (m_data.size() < sizeof(T)) {
+                return false;
+            }
+
+            std::memcpy(&dst, m_data.data(), sizeof(T));
+            m_data = m_data.subspan(sizeof(T));
+
+            return true;
+        }
+
+        template <typename T>
+        [[nodiscard]] inline bool readVector(std::vector<T>& dst) {
+            u32 size{};
+
+            if (!read(size) || m_data.size() / sizeof(T) < size) {
+                return false;
+            }
+
+            dst.resize(size);
+
+            for (auto& value : dst) {
+                if (!read(value)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        [[nodiscard]] inline bool readString(std::string& dst) {
+            std::vector<char> chars{};
+
+            if (!readVector(chars)) {
+                return false;
+            }
+
+            dst.assign(chars.begin(), chars.end());
+            return true;
+        }
+
+    private:
+        std::span<const u8> m_data;
+    };
+
+    // every message tagged with a search id belongs to the search the coordinator
+    // started with that id, and is ignored once another search has been started
+    struct SearchRequest {
+        u32 searchId{};
+        std::string sfen{};
+        std::vector<u64> keyHistory{};
+        // the worker's share of the root moves
+        std::vector<Move> rootMoves{};
+    };
+
+    struct StopRequest {
+        u32 searchId{};
+    };
+
+    struct LineReport {
+        u32 searchId{};
+        i32 depth{};
+        Score score{};
+        PvList pv{};
+    };
+
+    struct TtEntries {
+        u32 searchId{};
+        std::vector<tt::SharedEntry> entries{};
+    };
+
+    [[nodiscard]] std::vector<u8> encode(const SearchRequest& msg);
+    [[nodiscard]] std::vector<u8> encode(const StopRequest& msg);
+    [[nodiscard]] std::vector<u8> encode(const LineReport& msg);
+    [[nodiscard]] std::vector<u8> encode(const TtEntries& msg);
+
+    [[nodiscard]] bool decode(SearchRequest& dst, std::span<const u8> payload);
+    [[nodiscard]] bool decode(StopRequest& dst, std::span<const u8> payload);
+    [[nodiscard]] bool decode(LineReport& dst, std::span<const u8> payload);
+    [[nodiscard]] bool decode(TtEntries& dst, std::span<const u8> payload);
+} // namespace stoat::cluster
@@ -0,0 +1,273 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "socket.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace stoat::cluster {
+    namespace {
+        constexpr std::string_view kUnixPrefix = "unix:";
+        constexpr std::string_view kTcpPrefix = "tcp:";
+
+        constexpr i32 kListenBacklog = 8;
+
+        struct ParsedAddress {
+            bool isUnix{};
+            // socket path for unix sockets
+            std::string host{};
+            std::string port{};
+        };
+
+        [[nodiscard]] std::optional<ParsedAddress> parseAddress(std::string_view address) {
+            if (address.starts_with(kUnixPrefix)) {
+                auto path = address.substr(kUnixPrefix.size());
+
+                if (path.empty() || path.size() >= sizeof(sockaddr_un::sun_path)) {
+                    fmt::println(stderr, "Invalid unix socket path '{}'", path);
+                    return {};
+                }
+
+                return ParsedAddress{.isUnix = true, .host = std::string{path}};
+            }
+
+            if (address.starts_with(kTcpPrefix)) {
+                const auto hostPort = address.substr(kTcpPrefix.size());
+                const auto colon = hostPort.rfind(':');
+
+                if (colon == std::string_view::npos || colon == 0 || colon == hostPort.size() - 1) {
+                    fmt::println(stderr, "Invalid tcp address '{}'", hostPort);
+                    return {};
+                }
+
+                return ParsedAddress{
+                    .isUnix = false,
+                    .host = std::string{hostPort.substr(0, colon)},
+                    .port = std::string{hostPort.substr(colon + 1)},
+                };
+            }
+
+            fmt::println(stderr, "Unknown address '{}' - expected unix:<path> or tcp:<host>:<port>", address);
+            return {};
+        }
+
+        [[nodiscard]] sockaddr_un unixAddress(const std::string& path) {
+            sockaddr_un result{};
+
+            result.sun_family = AF_UNIX;
+            std::memcpy(result.sun_path, path.c_str(), path.size() + 1);
+
+            return result;
+        }
+
+        // calls f with each resolved tcp address until it returns a valid socket
+        template <typename F>
+        [[nodiscard]] std::optional<Socket> withTcpAddresses(const ParsedAddress& address, bool passive, F f) {
+            addrinfo hints{};
+
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+            addrinfo* results{};
+
+            if (const auto error = getaddrinfo(address.host.c_str(), address.port.c_str(), &hints, &results)) {
+                fmt::println(stderr, "Failed to resolve {}:{}: {}", address.host, address.port, gai_strerror(error));
+                return {};
+            }
+
+            std::optional<Socket> socket{};
+
+            for (auto* curr = results; curr && !socket; curr = curr->ai_next) {
+                socket = f(*curr);
+            }
+
+            freeaddrinfo(results);
+
+            return socket;
+        }
+    } // namespace
+
+    Socket::~Socket() {
+        close();
+    }
+
+    Socket& Socket::operator=(Socket&& other) noexcept {
+        if (this != &other) {
+            close();
+
+            m_fd = other.m_fd;
+            other.m_fd = -1;
+        }
+
+        return *this;
+    }
+
+    std::optional<Socket> Socket::connect(std::string_view address) {
+        const auto parsed = parseAddress(address);
+
+        if (!parsed) {
+            return {};
+        }
+
+        if (parsed->isUnix) {
+            Socket socket{::socket(AF_UNIX, SOCK_STREAM, 0)};
+            const auto addr = unixAddress(parsed->host);
+
+            if (!socket.valid() || ::connect(socket.m_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+            {
+                fmt::println(stderr, "Failed to connect to {}: {}", address, std::strerror(errno));
+                return {};
+            }
+
+            return socket;
+        }
+
+        auto socket = withTcpAddresses(*parsed, false, [](const addrinfo& info) -> std::optional<Socket> {
+            Socket socket{::socket(info.ai_family, info.ai_socktype, info.ai_protocol)};
+
+            if (!socket.valid() || ::connect(socket.m_fd, info.ai_addr, info.ai_addrlen) != 0) {
+                return {};
+            }
+
+            return socket;
+        });
+
+        if (!socket) {
+            fmt::println(stderr, "Failed to connect to {}", address);
+        }
+
+        return socket;
+    }
+
+    std::optional<Socket> Socket::listen(std::string_view address) {
+        const auto parsed = parseAddress(address);
+
+        if (!parsed) {
+            return {};
+        }
+
+        if (parsed->isUnix) {
+            Socket socket{::socket(AF_UNIX, SOCK_STREAM, 0)};
+            const auto addr = unixAddress(parsed->host);
+
+            // clean up after a previous worker
+            ::unlink(parsed->host.c_str());
+
+            if (!socket.valid() || ::bind(socket.m_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0
+                || ::listen(socket.m_fd, kListenBacklog) != 0)
+            {
+                fmt::println(stderr, "Failed to listen on {}: {}", address, std::strerror(errno));
+                return {};
+            }
+
+            return socket;
+        }
+
+        auto socket = withTcpAddresses(*parsed, true, [](const addrinfo& info) -> std::optional<Socket> {
+            Socket socket{::socket(info.ai_family, info.ai_socktype, info.ai_protocol)};
+
+            if (!socket.valid()) {
+                return {};
+            }
+
+            const i32 reuse = 1;
+            ::setsockopt(socket.m_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            if (::bind(socket.m_fd, info.ai_addr, info.ai_addrlen) != 0 || ::listen(socket.m_fd, kListenBacklog) != 0) {
+                return {};
+            }
+
+            return socket;
+        });
+
+        if (!socket) {
+            fmt::println(stderr, "Failed to listen on {}", address);
+        }
+
+        return socket;
+    }
+
+    std::optional<Socket> Socket::accept() const {
+        const auto fd = ::accept(m_fd, nullptr, nullptr);
+
+        if (fd < 0) {
+            fmt::println(stderr, "Failed to accept connection: {}", std::strerror(errno));
+            return {};
+        }
+
+        return Socket{fd};
+    }
+
+    bool Socket::sendAll(std::span<const u8> data) const {
+        while (!data.empty()) {
+            const auto sent = ::send(m_fd, data.data(), data.size(), MSG_NOSIGNAL);
+
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (sent <= 0) {
+                return false;
+            }
+
+            data = data.subspan(static_cast<usize>(sent));
+        }
+
+        return true;
+    }
+
+    bool Socket::recvAll(std::span<u8> data) const {
+        while (!data.empty()) {
+            const auto received = ::recv(m_fd, data.data(), data.size(), 0);
+
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (received <= 0) {
+                return false;
+            }
+
+            data = data.subspan(static_cast<usize>(received));
+        }
+
+        return true;
+    }
+
+    bool Socket::waitReadable(i32 timeoutMs) const {
+        pollfd fd{.fd = m_fd, .events = POLLIN, .revents = 0};
+        return ::poll(&fd, 1, timeoutMs) > 0;
+    }
+
+    void Socket::close() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+} // namespace stoat::cluster
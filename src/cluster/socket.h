@@ -0,0 +1,69 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../types.h"
+
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace stoat::cluster {
+    // addresses are either "unix:<path>" or "tcp:<host>:<port>"
+    class Socket {
+    public:
+        Socket() = default;
+
+        explicit inline Socket(i32 fd) :
+                m_fd{fd} {}
+
+        ~Socket();
+
+        Socket(const Socket&) = delete;
+
+        inline Socket(Socket&& other) noexcept :
+                m_fd{other.m_fd} {
+            other.m_fd = -1;
+        }
+
+        Socket& operator=(const Socket&) = delete;
+        Socket& operator=(Socket&& other) noexcept;
+
+        [[nodiscard]] static std::optional<Socket> connect(std::string_view address);
+        [[nodiscard]] static std::optional<Socket> listen(std::string_view address);
+
+        [[nodiscard]] std::optional<Socket> accept() const;
+
+        [[nodiscard]] bool sendAll(std::span<const u8> data) const;
+        [[nodiscard]] bool recvAll(std::span<u8> data) const;
+
+        // false if nothing arrived within the timeout
+        [[nodiscard]] bool waitReadable(i32 timeoutMs) const;
+
+        void close();
+
+        [[nodiscard]] inline bool valid() const {
+            return m_fd >= 0;
+        }
+
+    private:
+        i32 m_fd{-1};
+    };
+} // namespace stoat::cluster
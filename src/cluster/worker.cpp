@@ -0,0 +1,199 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "worker.h"
+
+#include <memory>
+#include <vector>
+
+#include "../limit.h"
+#include "message.h"
+
+namespace stoat::cluster {
+    Worker::Worker(u32 threadCount, usize ttSizeMib) :
+            m_searcher{ttSizeMib} {
+        m_searcher.setThreadCount(threadCount);
+        m_searcher.setTtShareDepth(kTtShareDepth);
+        m_searcher.ensureReady();
+    }
+
+    Worker::~Worker() {
+        // the searcher reports through this object, so finish any search while it still exists
+        m_searcher.stop();
+    }
+
+    i32 Worker::run(std::string_view address) {
+        const auto listener = Socket::listen(address);
+
+        if (!listener) {
+            return 1;
+        }
+
+        fmt::println("worker listening on {}", address);
+
+        while (true) {
+            auto socket = listener->accept();
+
+            if (!socket) {
+                continue;
+            }
+
+            Connection connection{std::move(*socket)};
+            serve(connection);
+
+            fmt::println("coordinator disconnected");
+        }
+    }
+
+    protocol::CommandResult Worker::handleCommand(
+        [[maybe_unused]] std::string_view command,
+        [[maybe_unused]] std::span<std::string_view> args,
+        [[maybe_unused]] util::Instant startTime
+    ) {
+        return protocol::CommandResult::kUnknown;
+    }
+
+    void Worker::printSearchInfo(const protocol::SearchInfo& info) const {
+        // bounds from aspiration failures and secondary multipv lines are not worth sending
+        if (info.pvIdx != 0 || info.scoreBound != protocol::ScoreBound::kExact || info.pv.length == 0) {
+            return;
+        }
+
+        LineReport report{};
+
+        report.searchId = m_searchId.load();
+        report.depth = info.depth;
+        report.pv = info.pv;
+
+        if (const auto* mate = std::get_if<protocol::MateDisplayScore>(&info.score)) {
+            report.score = mate->plies > 0 ? kScoreMate - mate->plies : -kScoreMate - mate->plies;
+        } else {
+            report.score = std::get<protocol::CpDisplayScore>(info.score).score;
+        }
+
+        const std::unique_lock lock{m_connectionMutex};
+
+        if (m_connection) {
+            m_connection->send(MessageType::kInfo, encode(report));
+        }
+    }
+
+    void Worker::printInfoString(std::string_view str) const {
+        fmt::println("info string {}", str);
+    }
+
+    bool Worker::handleEnteringKingsWin() const {
+        // leave declaring to the coordinator, and search anyway
+        return false;
+    }
+
+    void Worker::serve(Connection& connection) {
+        {
+            const std::unique_lock lock{m_connectionMutex};
+            m_connection = &connection;
+        }
+
+        std::vector<tt::SharedEntry> sharedEntries{};
+
+        while (connection.isOpen()) {
+            if (const auto message = connection.receive(kPollIntervalMs)) {
+                handleMessage(connection, *message);
+            }
+
+            if (m_searcher.isSearching()) {
+                m_searcher.takeSharedTtEntries(sharedEntries);
+
+                if (!sharedEntries.empty()) {
+                    connection.send(MessageType::kTtEntries, encode(TtEntries{m_searchId.load(), sharedEntries}));
+                }
+            }
+        }
+
+        m_searcher.stop();
+
+        const std::unique_lock lock{m_connectionMutex};
+        m_connection = nullptr;
+    }
+
+    void Worker::handleMessage([[maybe_unused]] Connection& connection, const Message& message) {
+        switch (message.type) {
+            case MessageType::kSearch: {
+                SearchRequest request{};
+
+                if (!decode(request, message.payload)) {
+                    fmt::println(stderr, "Malformed search request");
+                    break;
+                }
+
+                auto pos = Position::fromSfen(request.sfen);
+
+                if (!pos) {
+                    fmt::println(stderr, "Invalid sfen '{}' in search request", request.sfen);
+                    break;
+                }
+
+                if (m_searcher.isSearching()) {
+                    m_searcher.stop();
+                }
+
+                m_searchId.store(request.searchId);
+
+                // run until the coordinator says to stop
+                m_searcher.startSearch(
+                    pos.take(),
+                    request.keyHistory,
+                    util::Instant::now(),
+                    true,
+                    false,
+                    kMaxDepth,
+                    std::make_unique<limit::CompoundLimiter>(),
+                    request.rootMoves
+                );
+
+                break;
+            }
+
+            case MessageType::kStop: {
+                StopRequest request{};
+
+                if (decode(request, message.payload) && request.searchId == m_searchId.load()) {
+                    m_searcher.stop();
+                }
+
+                break;
+            }
+
+            case MessageType::kTtEntries: {
+                TtEntries entries{};
+
+                if (decode(entries, message.payload) && entries.searchId == m_searchId.load()
+                    && m_searcher.isSearching())
+                {
+                    m_searcher.importTtEntries(entries.entries);
+                }
+
+                break;
+            }
+
+            default:
+                fmt::println(stderr, "Unexpected message type {} from coordinator", static_cast<u32>(message.type));
+                break;
+        }
+    }
+} // namespace stoat::cluster
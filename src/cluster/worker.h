@@ -0,0 +1,74 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../types.h"
+
+#include <mutex>
+#include <string_view>
+
+#include "../protocol/handler.h"
+#include "../search.h"
+#include "connection.h"
+
+namespace stoat::cluster {
+    // tt writes at or above this depth are exchanged between cluster members
+    constexpr i32 kTtShareDepth = 10;
+
+    constexpr i32 kPollIntervalMs = 20;
+
+    // a worker engine process. searches whatever the connected coordinator
+    // asks it to, and stands in for the protocol handler to send its
+    // results back over the connection instead of printing them
+    class Worker final : public protocol::IProtocolHandler {
+    public:
+        Worker(u32 threadCount, usize ttSizeMib);
+        ~Worker() final;
+
+        // serves coordinators one at a time until killed
+        i32 run(std::string_view address);
+
+        void printInitialInfo() const final {}
+
+        [[nodiscard]] protocol::CommandResult handleCommand(
+            std::string_view command,
+            std::span<std::string_view> args,
+            util::Instant startTime
+        ) final;
+
+        void printSearchInfo(const protocol::SearchInfo& info) const final;
+        void printInfoString(std::string_view str) const final;
+        void printBestMove(Move move, Move ponderMove) const final {}
+        void printMateResult(const mate::MateResult& result) const final {}
+        void handleNoLegalMoves() const final {}
+        bool handleEnteringKingsWin() const final;
+
+    private:
+        Searcher m_searcher;
+
+        mutable std::mutex m_connectionMutex{};
+        Connection* m_connection{};
+
+        std::atomic<u32> m_searchId{};
+
+        void serve(Connection& connection);
+        void handleMessage(Connection& connection, const Message& message);
+    };
+} // namespace stoat::cluster
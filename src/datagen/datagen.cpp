@@ -76,10 +76,6 @@ namespace stoat::datagen {
                 const auto idx = start + rng.nextU32(moves.size() - start);
                 const auto move = moves[idx];
 
-                if (!pos.isLegal(move)) {
-                    continue;
-                }
-
                 keyHistory.push_back(pos.key());
                 const auto newPos = pos.applyMove(move);
                 const auto sennichite = newPos.testSennichite(false, keyHistory);
@@ -118,7 +114,7 @@ namespace stoat::datagen {
 
                 for (usize i = 0; i < count; ++i) {
                     moves.clear();
-                    movegen::generateAll(moves, pos);
+                    movegen::generateLegal(moves, pos);
 
                     const auto move = selectRandomLegal(rng, pos, keyHistory, moves);
 
@@ -0,0 +1,87 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "types.h"
+
+#include <array>
+#include <cassert>
+#include <span>
+
+#include "core.h"
+#include "util/static_vector.h"
+
+namespace stoat {
+    // keys of the positions leading up to the one being searched, with a counting filter over
+    // them so that a position that has not been seen before is ruled out as a repetition without a scan
+    class KeyHistory {
+    public:
+        // search only looks back 16 plies for repetitions, so older game history is dropped
+        static constexpr usize kMaxGameKeys = 64;
+        static constexpr usize kCapacity = kMaxGameKeys + kMaxDepth + 1;
+
+        inline void reset(std::span<const u64> gameKeys) {
+            m_keys.clear();
+            m_filter.fill(0);
+
+            if (gameKeys.size() > kMaxGameKeys) {
+                gameKeys = gameKeys.last(kMaxGameKeys);
+            }
+
+            for (const auto key : gameKeys) {
+                push(key);
+            }
+        }
+
+        inline void push(u64 key) {
+            m_keys.push(key);
+            ++m_filter[filterIdx(key)];
+        }
+
+        inline void pop() {
+            assert(!m_keys.empty());
+
+            const auto key = m_keys[m_keys.size() - 1];
+            m_keys.resize(m_keys.size() - 1);
+
+            assert(m_filter[filterIdx(key)] > 0);
+            --m_filter[filterIdx(key)];
+        }
+
+        // false positives are possible, false negatives are not
+        [[nodiscard]] inline bool mayContain(u64 key) const {
+            return m_filter[filterIdx(key)] > 0;
+        }
+
+        [[nodiscard]] inline std::span<const u64> keys() const {
+            return {m_keys.begin(), m_keys.end()};
+        }
+
+    private:
+        static constexpr usize kFilterSize = 1024;
+
+        [[nodiscard]] static constexpr usize filterIdx(u64 key) {
+            return static_cast<usize>(key) % kFilterSize;
+        }
+
+        util::StaticVector<u64, kCapacity> m_keys{};
+        std::array<u16, kFilterSize> m_filter{};
+    };
+} // namespace stoat
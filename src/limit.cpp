@@ -18,6 +18,8 @@
 
 #include "limit.h"
 
+#include "trace.h"
+
 namespace stoat::limit {
     namespace {
         constexpr usize kTimeCheckInterval = 2048;
@@ -52,6 +54,10 @@ namespace stoat::limit {
     MoveTimeLimiter::MoveTimeLimiter(util::Instant startTime, f64 maxTime) :
             m_startTime{startTime}, m_maxTime{maxTime} {}
 
+    void MoveTimeLimiter::restartClock(util::Instant startTime) {
+        m_startTime = startTime;
+    }
+
     bool MoveTimeLimiter::stopSoft(usize nodes) {
         return m_startTime.elapsed() >= m_maxTime;
     }
@@ -91,22 +97,30 @@ namespace stoat::limit {
     }
 
     void TimeManager::update(i32 depth, Move bestMove) {
+        const auto prevScale = m_scale;
+
         m_scale = 1.0;
 
-        if (depth <= 5) {
-            return;
+        if (depth > 5) {
+            const auto bestMoveNodes = [&] {
+                if (bestMove.isDrop()) {
+                    return m_drop[bestMove.dropPiece().idx()][bestMove.to().idx()];
+                } else {
+                    return m_nonDrop[bestMove.isPromo()][bestMove.from().idx()][bestMove.to().idx()];
+                }
+            }();
+
+            const auto bestMoveNodeFraction = static_cast<f64>(bestMoveNodes) / static_cast<f64>(m_totalNodes);
+            m_scale *= 2.2 - bestMoveNodeFraction * 1.6;
         }
 
-        const auto bestMoveNodes = [&] {
-            if (bestMove.isDrop()) {
-                return m_drop[bestMove.dropPiece().idx()][bestMove.to().idx()];
-            } else {
-                return m_nonDrop[bestMove.isPromo()][bestMove.from().idx()][bestMove.to().idx()];
-            }
-        }();
+        if (m_scale != prevScale) {
+            trace::counter("time scale", m_scale);
+        }
+    }
 
-        const auto bestMoveNodeFraction = static_cast<f64>(bestMoveNodes) / static_cast<f64>(m_totalNodes);
-        m_scale *= 2.2 - bestMoveNodeFraction * 1.6;
+    void TimeManager::restartClock(util::Instant startTime) {
+        m_startTime = startTime;
     }
 
     bool TimeManager::stopSoft(usize nodes) {
@@ -37,6 +37,10 @@ namespace stoat::limit {
 
         virtual void update(i32 depth, Move bestMove) {}
 
+        // called on ponderhit - time-based limiters
+        // start counting their budget from this point
+        virtual void restartClock(util::Instant startTime) {}
+
         [[nodiscard]] virtual bool stopSoft(usize nodes) = 0;
         [[nodiscard]] virtual bool stopHard(usize nodes) = 0;
     };
@@ -62,6 +66,12 @@ namespace stoat::limit {
             }
         }
 
+        inline void restartClock(util::Instant startTime) final {
+            for (auto& limiter : m_limiters) {
+                limiter->restartClock(startTime);
+            }
+        }
+
         [[nodiscard]] inline bool stopSoft(usize nodes) final {
             return std::ranges::any_of(m_limiters, [&](const auto& limiter) { return limiter->stopSoft(nodes); });
         }
@@ -104,6 +114,8 @@ namespace stoat::limit {
         MoveTimeLimiter(util::Instant startTime, f64 maxTime);
         ~MoveTimeLimiter() final = default;
 
+        void restartClock(util::Instant startTime) final;
+
         [[nodiscard]] bool stopSoft(usize nodes) final;
         [[nodiscard]] bool stopHard(usize nodes) final;
 
@@ -127,6 +139,8 @@ namespace stoat::limit {
 
         void update(i32 depth, Move bestMove) final;
 
+        void restartClock(util::Instant startTime) final;
+
         [[nodiscard]] bool stopSoft(usize nodes) final;
         [[nodiscard]] bool stopHard(usize nodes) final;
 
@@ -23,7 +23,10 @@
 #include <vector>
 
 #include "bench.h"
+#include "cluster/worker.h"
 #include "datagen/datagen.h"
+#include "microbench.h"
+#include "perft.h"
 #include "protocol/handler.h"
 #include "util/ctrlc.h"
 #include "util/parse.h"
@@ -56,8 +59,210 @@ namespace stoat {
             return datagen::run(args[2], threads);
         }
 
+        i32 runBench(std::span<const std::string_view> args) {
+            const auto printUsage = [&] {
+                fmt::println(
+                    stderr,
+                    "usage: {0} bench [scaling] [depth] [threads] [abdada] [hash] [sfen file]\n"
+                    "       {0} bench json [repetitions] [depth] [threads] [abdada] [hash] [sfen file]\n"
+                    "       {0} bench compare <baseline json> [repetitions]",
+                    args[0]
+                );
+            };
+
+            if (args.size() >= 3 && args[2] == "compare") {
+                if (args.size() < 4) {
+                    printUsage();
+                    return 1;
+                }
+
+                u32 repetitions = bench::kDefaultCompareRepetitions;
+
+                if (args.size() >= 5 && !util::tryParse(repetitions, args[4])) {
+                    fmt::println(stderr, "invalid repetition count \"{}\"", args[4]);
+                    printUsage();
+                    return 1;
+                }
+
+                return bench::runCompare(args[3], repetitions) ? 0 : 1;
+            }
+
+            const bool scaling = args.size() >= 3 && args[2] == "scaling";
+            const bool json = args.size() >= 3 && args[2] == "json";
+            u32 repetitions = bench::kDefaultCompareRepetitions;
+
+            if (json && args.size() >= 4 && !util::tryParse(repetitions, args[3])) {
+                fmt::println(stderr, "invalid repetition count \"{}\"", args[3]);
+                printUsage();
+                return 1;
+            }
+
+            const usize first = json ? 4 : scaling ? 3 : 2;
+
+            bench::BenchConfig config{};
+
+            if (args.size() > first && !util::tryParse(config.depth, args[first])) {
+                fmt::println(stderr, "invalid depth \"{}\"", args[first]);
+                printUsage();
+                return 1;
+            }
+
+            if (args.size() > first + 1 && !util::tryParse(config.threads, args[first + 1])) {
+                fmt::println(stderr, "invalid thread count \"{}\"", args[first + 1]);
+                printUsage();
+                return 1;
+            }
+
+            if (args.size() > first + 2 && !util::tryParseBool(config.abdada, args[first + 2])) {
+                fmt::println(stderr, "invalid abdada value \"{}\"", args[first + 2]);
+                printUsage();
+                return 1;
+            }
+
+            if (args.size() > first + 3 && !util::tryParse(config.ttSizeMib, args[first + 3])) {
+                fmt::println(stderr, "invalid hash size \"{}\"", args[first + 3]);
+                printUsage();
+                return 1;
+            }
+
+            if (args.size() > first + 4) {
+                config.sfenFile = args[first + 4];
+            }
+
+            config.threads = kThreadCountRange.clamp(config.threads);
+            config.ttSizeMib = tt::kTtSizeRange.clamp(config.ttSizeMib);
+
+            bool success;
+
+            if (scaling) {
+                success = bench::runScaling(config);
+            } else if (json) {
+                success = bench::runJson(config, repetitions);
+            } else {
+                success = bench::run(config);
+            }
+
+            return success ? 0 : 1;
+        }
+
+        i32 runMicrobench(std::span<const std::string_view> args) {
+            const auto printUsage = [&] {
+                fmt::println(stderr, "usage: {} microbench [samples] [csv] [sfen file]", args[0]);
+            };
+
+            microbench::MicrobenchConfig config{};
+
+            if (args.size() >= 3 && !util::tryParse(config.samples, args[2])) {
+                fmt::println(stderr, "invalid sample count \"{}\"", args[2]);
+                printUsage();
+                return 1;
+            }
+
+            if (args.size() >= 4 && !util::tryParseBool(config.csv, args[3])) {
+                fmt::println(stderr, "invalid csv value \"{}\"", args[3]);
+                printUsage();
+                return 1;
+            }
+
+            if (args.size() >= 5) {
+                config.sfenFile = args[4];
+            }
+
+            return microbench::run(config) ? 0 : 1;
+        }
+
+        i32 runPerft(std::span<const std::string_view> args) {
+            const auto printUsage = [&] {
+                fmt::println(stderr, "usage: {} perft <depth> [threads] [hash] [sfen]", args[0]);
+            };
+
+            if (args.size() < 3) {
+                printUsage();
+                return 1;
+            }
+
+            i32 depth{};
+            u32 threads = kDefaultPerftThreads;
+            usize hash = kDefaultPerftHashMib;
+
+            if (!util::tryParse(depth, args[2])) {
+                fmt::println(stderr, "invalid depth \"{}\"", args[2]);
+                printUsage();
+                return 1;
+            }
+
+            if (args.size() >= 4 && !util::tryParse(threads, args[3])) {
+                fmt::println(stderr, "invalid thread count \"{}\"", args[3]);
+                printUsage();
+                return 1;
+            }
+
+            if (args.size() >= 5 && !util::tryParse(hash, args[4])) {
+                fmt::println(stderr, "invalid hash size \"{}\"", args[4]);
+                printUsage();
+                return 1;
+            }
+
+            auto pos = Position::startpos();
+
+            // the sfen may have been passed as one argument or several
+            if (args.size() >= 6) {
+                std::string sfen{args[5]};
+
+                for (usize idx = 6; idx < args.size(); ++idx) {
+                    sfen += ' ';
+                    sfen += args[idx];
+                }
+
+                auto parsed = Position::fromSfen(sfen);
+
+                if (!parsed) {
+                    fmt::println(stderr, "invalid sfen \"{}\": {}", sfen, parsed.takeErr().message());
+                    printUsage();
+                    return 1;
+                }
+
+                pos = parsed.take();
+            }
+
+            splitPerft(pos, depth, kPerftThreadsRange.clamp(threads), kPerftHashRange.clamp(hash));
+
+            return 0;
+        }
+
         // :doom:
         const protocol::IProtocolHandler* s_currHandler;
+
+        i32 runWorker(std::span<const std::string_view> args) {
+            const auto printUsage = [&] {
+                fmt::println(stderr, "usage: {} worker <unix:path|tcp:host:port> [threads] [hash]", args[0]);
+            };
+
+            if (args.size() < 3) {
+                printUsage();
+                return 1;
+            }
+
+            u32 threads = kDefaultThreadCount;
+            usize hash = tt::kDefaultTtSizeMib;
+
+            if (args.size() >= 4 && !util::tryParse(threads, args[3])) {
+                fmt::println(stderr, "invalid thread count \"{}\"", args[3]);
+                printUsage();
+                return 1;
+            }
+
+            if (args.size() >= 5 && !util::tryParse(hash, args[4])) {
+                fmt::println(stderr, "invalid hash size \"{}\"", args[4]);
+                printUsage();
+                return 1;
+            }
+
+            cluster::Worker worker{kThreadCountRange.clamp(threads), tt::kTtSizeRange.clamp(hash)};
+            s_currHandler = &worker;
+
+            return worker.run(args[2]);
+        }
     } // namespace
 
     namespace protocol {
@@ -79,10 +284,15 @@ namespace stoat {
         if (args.size() > 1) {
             const auto subcommand = args[1];
             if (subcommand == "bench") {
-                bench::run();
-                return 0;
+                return runBench(args);
+            } else if (subcommand == "perft") {
+                return runPerft(args);
+            } else if (subcommand == "microbench") {
+                return runMicrobench(args);
             } else if (subcommand == "datagen") {
                 return runDatagen(args);
+            } else if (subcommand == "worker") {
+                return runWorker(args);
             }
         }
 
@@ -90,6 +300,12 @@ namespace stoat {
         Searcher searcher{tt::kDefaultTtSizeMib};
         state.searcher = &searcher;
 
+        mate::MateSolver mateSolver{mate::kDefaultMateTtSizeMib};
+        state.mateSolver = &mateSolver;
+
+        cluster::Coordinator coordinator{searcher};
+        state.cluster = &coordinator;
+
         std::vector<std::string_view> tokens{};
 
         std::string line{};
@@ -117,7 +333,7 @@ namespace stoat {
                 break;
             } else if (result == protocol::CommandResult::kUnknown) {
                 if (auto newHandler = protocol::createHandler(command, state)) {
-                    if (searcher.isSearching()) {
+                    if (searcher.isSearching() || mateSolver.isSolving()) {
                         fmt::println(stderr, "Still searching");
                         continue;
                     }
@@ -0,0 +1,213 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "mate1.h"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+
+#include "../attacks/attacks.h"
+
+namespace stoat::mate {
+    namespace {
+        constexpr std::array kDropCheckers = {
+            PieceTypes::kLance,
+            PieceTypes::kKnight,
+            PieceTypes::kSilver,
+            PieceTypes::kGold,
+            PieceTypes::kBishop,
+            PieceTypes::kRook,
+        };
+
+        [[nodiscard]] bool isMateAfter(const Position& pos, Move move, Bitboard unblockable) {
+            const auto newPos = pos.applyMove(move);
+
+            const auto attacker = pos.stm();
+            const auto defender = attacker.flip();
+
+            const auto kingSq = newPos.kingSq(defender);
+            const auto checkers = newPos.checkers();
+
+            // checks from a distance could be blocked
+            if (checkers.empty() || !(checkers & ~unblockable).empty()) {
+                return false;
+            }
+
+            if (checkers.one()) {
+                const auto capturers =
+                    newPos.attackersTo(checkers.lsb(), defender) & ~newPos.pieceBb(PieceTypes::kKing, defender);
+
+                if (!capturers.empty()) {
+                    return false;
+                }
+            }
+
+            const auto kinglessOcc = newPos.occupancy() ^ Bitboard::fromSquare(kingSq);
+
+            auto escapes = attacks::kingAttacks(kingSq) & ~newPos.colorBb(defender);
+            while (!escapes.empty()) {
+                const auto sq = escapes.popLsb();
+                if (!newPos.isAttacked(sq, attacker, kinglessOcc)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    } // namespace
+
+    Move findMateIn1(const Position& pos) {
+        assert(!pos.isInCheck());
+
+        const auto us = pos.stm();
+        const auto them = us.flip();
+
+        const auto kingSq = pos.kingSq(them);
+        const auto kingBb = Bitboard::fromSquare(kingSq);
+
+        const auto occ = pos.occupancy();
+        const auto ours = pos.colorBb(us);
+        const auto theirNonKing = pos.colorBb(them) ^ kingBb;
+
+        const auto kinglessOcc = occ ^ kingBb;
+
+        const auto contactSquares = attacks::kingAttacks(kingSq) & ~ours;
+
+        // only knights can give check from these squares
+        const bool haveKnights =
+            pos.hand(us).count(PieceTypes::kKnight) > 0 || !pos.pieceBb(PieceTypes::kKnight, us).empty();
+        const auto knightCheckSquares = haveKnights ? attacks::knightAttacks(kingSq, them) & ~ours : Bitboards::kEmpty;
+
+        // contact and knight checks are the only checks that cannot be blocked
+        const auto unblockable = contactSquares | knightCheckSquares;
+
+        const auto& hand = pos.hand(us);
+
+        // squares next to their king that we already attack, filled in when first needed
+        std::optional<Bitboard> covered{};
+
+        const auto getCovered = [&] {
+            if (!covered) {
+                covered = Bitboards::kEmpty;
+
+                auto neighbours = attacks::kingAttacks(kingSq) & ~pos.colorBb(them);
+                while (!neighbours.empty()) {
+                    const auto sq = neighbours.popLsb();
+                    if (pos.isAttacked(sq, us, kinglessOcc)) {
+                        covered->setSquare(sq);
+                    }
+                }
+            }
+
+            return *covered;
+        };
+
+        auto targets = unblockable;
+        while (!targets.empty()) {
+            const auto to = targets.popLsb();
+            const auto toBb = Bitboard::fromSquare(to);
+
+            const bool contact = contactSquares.getSquare(to);
+            const bool canDrop = !occ.getSquare(to);
+
+            const auto ourAttackers = pos.attackersTo(to, us);
+
+            const bool anyDrop = canDrop && std::ranges::any_of(kDropCheckers, [&](PieceType pt) {
+                return hand.count(pt) > 0 && attacks::pieceAttacks(pt, kingSq, them, occ).getSquare(to);
+            });
+
+            if (!anyDrop && (ourAttackers & ~pos.pieceBb(PieceTypes::kKing, us)).empty()) {
+                continue;
+            }
+
+            // a checker that can be captured by anything other than the king does not mate.
+            // moving a piece can only ever uncover more attacks on the checker, so this
+            // also rules out every move to this square
+            if (!(pos.attackersTo(to, them) & theirNonKing).empty()) {
+                continue;
+            }
+
+            // pawn drops are skipped entirely, as a pawn drop mate is illegal
+            if (anyDrop && !(contact && ourAttackers.empty())) {
+                for (const auto pt : kDropCheckers) {
+                    if (hand.count(pt) == 0 || !attacks::pieceAttacks(pt, kingSq, them, occ).getSquare(to)) {
+                        continue;
+                    }
+
+                    // dropping a piece can block our own attacks on the king's escape
+                    // squares, so this is only a quick rejection - see isMateAfter
+                    const auto checkerAttacks = attacks::pieceAttacks(pt, to, us, kinglessOcc | toBb);
+                    const auto escapes = attacks::kingAttacks(kingSq) & ~pos.colorBb(them) & ~toBb;
+
+                    if (!(escapes & ~checkerAttacks & ~getCovered()).empty()) {
+                        continue;
+                    }
+
+                    const auto move = Move::makeDrop(pt, to);
+
+                    if (pos.isPseudolegal(move) && isMateAfter(pos, move, unblockable)) {
+                        return move;
+                    }
+                }
+            }
+
+            auto candidates = ourAttackers & ~pos.pieceBb(PieceTypes::kKing, us);
+            while (!candidates.empty()) {
+                const auto from = candidates.popLsb();
+                const auto fromBb = Bitboard::fromSquare(from);
+
+                const auto newOcc = occ ^ fromBb;
+                const auto newAttackers = pos.allAttackersTo(to, newOcc);
+
+                // the king can take an undefended contact checker
+                if (!(newAttackers & theirNonKing).empty()
+                    || contact && (newAttackers & ours & ~fromBb).empty())
+                {
+                    continue;
+                }
+
+                const auto moving = pos.pieceOn(from);
+
+                for (const bool promo : {true, false}) {
+                    if (promo && !moving.type().canPromote()) {
+                        continue;
+                    }
+
+                    const auto move = promo ? Move::makePromotion(from, to) : Move::makeNormal(from, to);
+                    const auto pt = promo ? moving.type().promoted() : moving.type();
+
+                    if (!attacks::pieceAttacks(pt, to, us, newOcc).getSquare(kingSq)) {
+                        continue;
+                    }
+
+                    if (!pos.isPseudolegal(move) || !pos.isLegal(move)) {
+                        continue;
+                    }
+
+                    if (isMateAfter(pos, move, unblockable)) {
+                        return move;
+                    }
+                }
+            }
+        }
+
+        return kNullMove;
+    }
+} // namespace stoat::mate
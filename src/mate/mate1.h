@@ -0,0 +1,34 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../types.h"
+
+#include "../move.h"
+#include "../position.h"
+
+namespace stoat::mate {
+    // Returns a move that mates immediately, or a null move if none was found.
+    // Only considers checks that cannot be blocked, and treats every defender
+    // attacking the checker as able to capture it, so this may miss mates,
+    // but will never return a move that is not mate. The side to move must
+    // not be in check. Pawn drops are never returned (uchifuzume).
+    [[nodiscard]] Move findMateIn1(const Position& pos);
+} // namespace stoat::mate
@@ -0,0 +1,364 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "solver.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "../movegen.h"
+#include "../protocol/handler.h"
+
+namespace stoat::mate {
+    namespace {
+        constexpr usize kLimiterCheckInterval = 1024;
+
+        // the same position has a different meaning depending on which side is
+        // attacking, so entries for a white attacker are stored under a different key
+        constexpr u64 kWhiteAttackerKey = 0x9E3779B97F4A7C15;
+
+        [[nodiscard]] constexpr bool isAttackerPly(i32 ply) {
+            return ply % 2 == 0;
+        }
+    } // namespace
+
+    MateSolver::MateSolver(usize ttSizeMib) :
+            m_table{ttSizeMib} {}
+
+    MateSolver::~MateSolver() {
+        stop();
+    }
+
+    void MateSolver::setTtSize(usize mib) {
+        assert(!isSolving());
+        m_table.resize(mib);
+    }
+
+    void MateSolver::ensureReady() {
+        assert(!isSolving());
+        m_table.finalize();
+    }
+
+    void MateSolver::startSolve(const Position& pos, std::unique_ptr<limit::ISearchLimiter> limiter) {
+        assert(!isSolving());
+
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+
+        clear();
+
+        m_stop.store(false);
+        m_solving.store(true);
+
+        m_thread = std::thread{[this, pos, limiter = std::move(limiter)] {
+            const auto result = solve(pos, *limiter);
+            protocol::currHandler().printMateResult(result);
+
+            m_solving.store(false);
+        }};
+    }
+
+    void MateSolver::stop() {
+        m_stop.store(true, std::memory_order::relaxed);
+
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    bool MateSolver::isSolving() const {
+        return m_solving.load();
+    }
+
+    void MateSolver::clear() {
+        assert(!isSolving());
+
+        if (!m_table.finalize()) {
+            m_table.clear();
+        }
+    }
+
+    MateResult MateSolver::solve(const Position& pos, limit::ISearchLimiter& limiter, std::span<const Move> rootMoves) {
+        m_table.finalize();
+
+        m_limiter = &limiter;
+        m_rootMoves = rootMoves;
+        m_nodes = 0;
+
+        m_keyMask = pos.stm() == Colors::kWhite ? kWhiteAttackerKey : 0;
+
+        m_aborted = false;
+
+        MateResult result{};
+
+        ProbedMateEntry rootEntry{};
+
+        // mid only returns early if aborted or if the root entry got overwritten
+        while (!m_aborted) {
+            mid(pos, kPnInfinity, kPnInfinity, 0);
+
+            if (m_table.probe(rootEntry, tableKey(pos)) && (rootEntry.phi == 0 || rootEntry.delta == 0)) {
+                break;
+            }
+        }
+
+        if (m_aborted) {
+            result.status = MateStatus::kTimeout;
+        } else if (rootEntry.delta == 0) {
+            result.status = MateStatus::kNoMate;
+        } else if (extractPv(result.pv, pos)) {
+            result.status = MateStatus::kMate;
+        } else {
+            result.status = MateStatus::kTimeout;
+        }
+
+        result.nodes = m_nodes;
+
+        m_rootMoves = {};
+
+        return result;
+    }
+
+    void MateSolver::generateChildren(const Position& pos, i32 ply) {
+        auto& dst = m_children[ply];
+        dst.clear();
+
+        movegen::MoveList moves{};
+
+        if (isAttackerPly(ply)) {
+            movegen::generateChecks(moves, pos);
+        } else {
+            movegen::generateEvasions(moves, pos);
+        }
+
+        dst.reserve(moves.size());
+
+        // repetitions are losses for the checking side, and lines too long to be
+        // represented are treated the same way - as depending on the whole line
+        const auto pathEnd = m_path.begin() + ply + 1;
+        const bool tooLong = ply + 1 >= kMaxMatePly;
+
+        for (const auto move : moves) {
+            if (ply == 0 && !m_rootMoves.empty() && std::ranges::find(m_rootMoves, move) == m_rootMoves.end()) {
+                continue;
+            }
+
+            const auto key = pos.keyAfter(move) ^ m_keyMask;
+
+            auto repetitionPly = kNoRepetition;
+
+            if (tooLong) {
+                repetitionPly = 0;
+            } else if (const auto repeated = std::find(m_path.begin(), pathEnd, key); repeated != pathEnd) {
+                repetitionPly = static_cast<i32>(repeated - m_path.begin());
+            }
+
+            dst.push_back({move, key, repetitionPly});
+        }
+    }
+
+    ProbedMateEntry MateSolver::probeChild(const Child& child, i32 childPly) const {
+        ProbedMateEntry entry{};
+
+        if (child.repetitionPly != kNoRepetition) {
+            if (isAttackerPly(childPly)) {
+                entry.phi = kPnInfinity;
+                entry.delta = 0;
+            } else {
+                entry.phi = 0;
+                entry.delta = kPnInfinity;
+            }
+
+            return entry;
+        }
+
+        m_table.probe(entry, child.key);
+        return entry;
+    }
+
+    i32 MateSolver::mid(const Position& pos, u32 thPhi, u32 thDelta, i32 ply) {
+        assert(ply >= 0 && ply < kMaxMatePly);
+
+        ++m_nodes;
+
+        if (m_nodes % kLimiterCheckInterval == 0
+            && (m_stop.load(std::memory_order::relaxed) || m_limiter->stopHard(m_nodes)))
+        {
+            m_aborted = true;
+        }
+
+        if (m_aborted) {
+            return kNoRepetition;
+        }
+
+        const auto startNodes = m_nodes;
+
+        m_path[ply] = tableKey(pos);
+
+        generateChildren(pos, ply);
+        auto& children = m_children[ply];
+
+        // no checks for the attacker, or no evasions for the defender
+        if (children.empty()) {
+            m_table.put(tableKey(pos), kPnInfinity, 0, kNullMove, 0, 1);
+            return kNoRepetition;
+        }
+
+        while (true) {
+            u32 phi = kPnInfinity;
+            u32 delta = 0;
+
+            usize bestIdx = 0;
+            u32 bestPhi = kPnInfinity;
+            u32 secondDelta = kPnInfinity;
+
+            for (usize idx = 0; idx < children.size(); ++idx) {
+                const auto entry = probeChild(children[idx], ply + 1);
+
+                if (entry.delta < phi) {
+                    secondDelta = phi;
+                    phi = entry.delta;
+                    bestIdx = idx;
+                    bestPhi = entry.phi;
+                } else if (entry.delta < secondDelta) {
+                    secondDelta = entry.delta;
+                }
+
+                // only a child that is actually lost for its side to move can prove this node
+                if (entry.phi == kPnInfinity) {
+                    delta = kPnInfinity;
+                } else if (delta != kPnInfinity) {
+                    delta = std::min(delta + entry.phi, kPnInfinity - 1);
+                }
+            }
+
+            if (phi >= thPhi || delta >= thDelta || m_aborted) {
+                auto bestMove = children[bestIdx].move;
+                u32 dist = 0;
+
+                // only disproofs can rely on repetitions - a win relies on them only
+                // if every winning child does, and a loss if any of its children do
+                auto repetitionPly = kNoRepetition;
+
+                if (phi == 0) {
+                    // won - take the shortest win
+                    dist = std::numeric_limits<u32>::max();
+                    repetitionPly = 0;
+
+                    for (const auto& child : children) {
+                        const auto entry = probeChild(child, ply + 1);
+                        if (entry.delta != 0) {
+                            continue;
+                        }
+
+                        repetitionPly = std::max(repetitionPly, child.repetitionPly);
+
+                        if (entry.dist < dist) {
+                            bestMove = child.move;
+                            dist = entry.dist;
+                        }
+                    }
+
+                    ++dist;
+                } else if (delta == 0) {
+                    // lost - take the longest loss
+                    for (const auto& child : children) {
+                        const auto entry = probeChild(child, ply + 1);
+                        repetitionPly = std::min(repetitionPly, child.repetitionPly);
+                        if (entry.dist >= dist) {
+                            bestMove = child.move;
+                            dist = entry.dist;
+                        }
+                    }
+
+                    ++dist;
+                }
+
+                // repeating this position or a later one is a loss on every line that reaches
+                // it, but a disproof relying on anything earlier only holds on this line - it is
+                // stored as nearly solved instead, so it can be read back elsewhere as a guide
+                if (repetitionPly < ply) {
+                    m_table.put(
+                        tableKey(pos),
+                        std::clamp<u32>(phi, 1, kPnInfinity - 1),
+                        std::clamp<u32>(delta, 1, kPnInfinity - 1),
+                        bestMove,
+                        0,
+                        m_nodes - startNodes + 1
+                    );
+
+                    return repetitionPly;
+                }
+
+                m_table.put(tableKey(pos), phi, delta, bestMove, dist, m_nodes - startNodes + 1);
+                return kNoRepetition;
+            }
+
+            const auto childThPhi =
+                static_cast<u32>(std::min<u64>(static_cast<u64>(thDelta) - delta + bestPhi, kPnInfinity));
+            const auto childThDelta = std::min(thPhi, secondDelta + 1);
+
+            const auto newPos = pos.applyMove(children[bestIdx].move);
+
+            children[bestIdx].repetitionPly = mid(newPos, childThPhi, childThDelta, ply + 1);
+        }
+    }
+
+    bool MateSolver::extractPv(PvList& pv, const Position& rootPos) {
+        pv.reset();
+
+        auto pos = rootPos;
+
+        for (i32 ply = 0; ply < kMaxMatePly; ++ply) {
+            const bool attacker = isAttackerPly(ply);
+
+            const auto isSolved = [&](const ProbedMateEntry& entry) {
+                return attacker ? entry.phi == 0 : entry.delta == 0;
+            };
+
+            ProbedMateEntry entry{};
+
+            // proofs can be overwritten, in which case solve this position again
+            if (!m_table.probe(entry, tableKey(pos)) || !isSolved(entry)) {
+                mid(pos, kPnInfinity, kPnInfinity, ply);
+
+                if (!m_table.probe(entry, tableKey(pos)) || !isSolved(entry)) {
+                    return false;
+                }
+            }
+
+            if (entry.dist == 0) {
+                // mated
+                return !attacker;
+            }
+
+            if (!pos.isPseudolegal(entry.move) || !pos.isLegal(entry.move)) {
+                return false;
+            }
+
+            m_path[ply] = tableKey(pos);
+
+            pv.moves[pv.length++] = entry.move;
+            pos = pos.applyMove(entry.move);
+        }
+
+        return false;
+    }
+} // namespace stoat::mate
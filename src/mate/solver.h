@@ -0,0 +1,129 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../types.h"
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../limit.h"
+#include "../position.h"
+#include "../pv.h"
+#include "table.h"
+
+namespace stoat::mate {
+    enum class MateStatus {
+        kMate = 0,
+        kNoMate,
+        kTimeout,
+    };
+
+    struct MateResult {
+        MateStatus status{MateStatus::kTimeout};
+        // only valid for kMate
+        PvList pv{};
+        usize nodes{};
+    };
+
+    // df-pn tsume solver - the side to move at the root is the attacker,
+    // and must give check with every move
+    class MateSolver {
+    public:
+        explicit MateSolver(usize ttSizeMib);
+        ~MateSolver();
+
+        void setTtSize(usize mib);
+        // allocates the table if it was resized, so that the first solve does not pay for it
+        void ensureReady();
+
+        // solves on a separate thread, and prints the result through the current protocol handler
+        void startSolve(const Position& pos, std::unique_ptr<limit::ISearchLimiter> limiter);
+        void stop();
+
+        [[nodiscard]] bool isSolving() const;
+
+        // if rootMoves is not empty, the attacker is restricted to those moves at the root
+        [[nodiscard]] MateResult solve(
+            const Position& pos,
+            limit::ISearchLimiter& limiter,
+            std::span<const Move> rootMoves = {}
+        );
+
+        // for callers solving on their own thread
+        void clear();
+
+    private:
+        static constexpr i32 kMaxMatePly = kMaxDepth - 1;
+        static constexpr i32 kNoRepetition = std::numeric_limits<i32>::max();
+
+        struct Child {
+            Move move;
+            u64 key;
+            // if this child is lost for the attacker only because it repeats a position on
+            // the current line, the ply of the earliest such position - see mid()
+            i32 repetitionPly;
+        };
+
+        MateTable m_table;
+
+        std::thread m_thread{};
+
+        std::atomic_bool m_stop{};
+        std::atomic_bool m_solving{};
+
+        limit::ISearchLimiter* m_limiter{};
+        usize m_nodes{};
+
+        // set when m_stop is seen or the limiter runs out
+        bool m_aborted{};
+
+        u64 m_keyMask{};
+
+        std::span<const Move> m_rootMoves{};
+
+        // keys of the positions on the current line, for repetition detection
+        std::array<u64, kMaxMatePly + 1> m_path{};
+
+        // moves at each ply of the current line, kept here rather than on
+        // the stack as lines can get deep enough to overflow it otherwise
+        std::array<std::vector<Child>, kMaxMatePly> m_children{};
+
+        [[nodiscard]] inline u64 tableKey(const Position& pos) const {
+            return pos.key() ^ m_keyMask;
+        }
+
+        // the attacker may only play checks, and the defender must get out of them
+        void generateChildren(const Position& pos, i32 ply);
+
+        [[nodiscard]] ProbedMateEntry probeChild(const Child& child, i32 childPly) const;
+
+        // a disproof that relies on repeating a position before this one holds only on the
+        // current line, so is not stored - the ply of that position is returned instead
+        i32 mid(const Position& pos, u32 thPhi, u32 thDelta, i32 ply);
+
+        bool extractPv(PvList& pv, const Position& rootPos);
+    };
+} // namespace stoat::mate
@@ -0,0 +1,135 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "../util/align.h"
+
+namespace stoat::mate {
+    MateTable::MateTable(usize mib) {
+        resize(mib);
+    }
+
+    MateTable::~MateTable() {
+        if (m_buckets) {
+            util::alignedFree(m_buckets);
+        }
+    }
+
+    void MateTable::resize(usize mib) {
+        const auto bytes = mib * 1024 * 1024;
+        const auto buckets = bytes / sizeof(Bucket);
+
+        if (m_bucketCount != buckets) {
+            if (m_buckets) {
+                util::alignedFree(m_buckets);
+            }
+
+            m_buckets = nullptr;
+            m_bucketCount = buckets;
+        }
+
+        m_pendingInit = true;
+    }
+
+    bool MateTable::finalize() {
+        if (!m_pendingInit) {
+            return false;
+        }
+
+        m_pendingInit = false;
+
+        // resizing to the same size keeps the old allocation
+        if (!m_buckets) {
+            m_buckets = util::alignedAlloc<Bucket>(kCacheLineSize, m_bucketCount);
+        }
+
+        if (!m_buckets) {
+            fmt::println(stderr, "Failed to reallocate mate TT - out of memory?");
+            std::terminate();
+        }
+
+        clear();
+
+        return true;
+    }
+
+    bool MateTable::probe(ProbedMateEntry& dst, u64 key) const {
+        assert(!m_pendingInit);
+
+        const auto& bucket = m_buckets[index(key)];
+
+        for (const auto& entry : bucket.entries) {
+            if (entry.key == key && entry.work > 0) {
+                dst.phi = entry.phi;
+                dst.delta = entry.delta;
+                dst.move = entry.move;
+                dst.dist = entry.dist;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void MateTable::put(u64 key, u32 phi, u32 delta, Move move, u32 dist, usize work) {
+        assert(!m_pendingInit);
+
+        assert(phi <= kPnInfinity);
+        assert(delta <= kPnInfinity);
+
+        auto& bucket = m_buckets[index(key)];
+
+        auto* slot = &bucket.entries[0];
+
+        for (auto& entry : bucket.entries) {
+            if (entry.key == key || entry.work == 0) {
+                slot = &entry;
+                break;
+            }
+
+            // solved positions are worth far more than their subtree
+            // size suggests, as the pv has to be read back out of them
+            const auto replacePriority = [](const Entry& e) {
+                return static_cast<u64>(e.work) + (e.solved() ? (u64{1} << 32) : 0);
+            };
+
+            if (replacePriority(entry) < replacePriority(*slot)) {
+                slot = &entry;
+            }
+        }
+
+        slot->key = key;
+        slot->phi = phi;
+        slot->delta = delta;
+        slot->work = static_cast<u32>(std::clamp<usize>(work, 1, std::numeric_limits<u32>::max()));
+        slot->move = move;
+        slot->dist = static_cast<u16>(std::min<u32>(dist, std::numeric_limits<u16>::max()));
+    }
+
+    void MateTable::clear() {
+        assert(!m_pendingInit);
+        std::memset(static_cast<void*>(m_buckets), 0, m_bucketCount * sizeof(Bucket));
+    }
+} // namespace stoat::mate
@@ -0,0 +1,90 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../types.h"
+
+#include <array>
+
+#include "../arch.h"
+#include "../move.h"
+#include "../util/range.h"
+
+namespace stoat::mate {
+    constexpr usize kDefaultMateTtSizeMib = 16;
+    constexpr util::Range<usize> kMateTtSizeRange{1, 131072};
+
+    // proof and disproof numbers are stored in negamax form - phi is the
+    // number for the side to move, delta the number for their opponent
+    constexpr u32 kPnInfinity = 0x3FFFFFFF;
+
+    struct ProbedMateEntry {
+        u32 phi{1};
+        u32 delta{1};
+        Move move{};
+        // plies to the end of the game, only meaningful for solved positions
+        u32 dist{};
+    };
+
+    class MateTable {
+    public:
+        explicit MateTable(usize mib);
+        ~MateTable();
+
+        void resize(usize mib);
+        bool finalize();
+
+        bool probe(ProbedMateEntry& dst, u64 key) const;
+        void put(u64 key, u32 phi, u32 delta, Move move, u32 dist, usize work);
+
+        void clear();
+
+    private:
+        struct Entry {
+            u64 key;
+            u32 phi;
+            u32 delta;
+            u32 work;
+            Move move;
+            u16 dist;
+
+            [[nodiscard]] inline bool solved() const {
+                return phi == 0 || delta == 0;
+            }
+        };
+
+        static_assert(sizeof(Entry) == 24);
+
+        static constexpr usize kBucketEntries = 8;
+
+        struct alignas(kCacheLineSize) Bucket {
+            std::array<Entry, kBucketEntries> entries;
+        };
+
+        bool m_pendingInit{};
+
+        Bucket* m_buckets{};
+        usize m_bucketCount{};
+
+        [[nodiscard]] constexpr usize index(u64 key) const {
+            return static_cast<usize>((static_cast<u128>(key) * static_cast<u128>(m_bucketCount)) >> 64);
+        }
+    };
+} // namespace stoat::mate
@@ -0,0 +1,510 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "microbench.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.h"
+#include "eval/nnue.h"
+#include "movegen.h"
+#include "position.h"
+#include "see.h"
+#include "ttable.h"
+#include "util/perf_counters.h"
+#include "util/timer.h"
+
+namespace stoat::microbench {
+    namespace {
+        // each sample repeats the loop over the corpus until it has run for at least this long
+        constexpr f64 kMinSampleTime = 0.02;
+
+        constexpr usize kTtSizeMib = 16;
+
+        // plies of history kept for each position when testing for sennichite
+        constexpr usize kHistoryLength = 32;
+
+        // keeps results alive so the timed loops are not optimised away
+        volatile u64 s_sink{};
+
+        struct Corpus {
+            std::vector<Position> positions{};
+            // legal moves of each position
+            std::vector<std::vector<Move>> legalMoves{};
+            // pseudolegal moves of each position
+            std::vector<movegen::MoveList> pseudolegalMoves{};
+            // synthetic key history for each position, for sennichite tests
+            std::vector<std::vector<u64>> keyHistories{};
+
+            usize totalLegalMoves{};
+            usize totalPseudolegalMoves{};
+        };
+
+        struct Context {
+            Corpus corpus{};
+            tt::TTable ttable{kTtSizeMib};
+            eval::nnue::NnueState nnueState{};
+        };
+
+        // one pass over the corpus, returning the number of operations performed
+        using BenchFunc = usize (*)(Context& ctx, u64& sink);
+
+        struct Component {
+            std::string_view name;
+            BenchFunc func;
+        };
+
+        struct Result {
+            std::string_view name;
+            usize opsPerSample;
+            f64 mean;
+            f64 stddev;
+            f64 min;
+
+            // hardware counters over every timed sample, per operation
+            std::optional<f64> cycles;
+            std::optional<f64> ipc;
+            std::optional<f64> l1dMisses;
+            std::optional<f64> llcMisses;
+            std::optional<f64> branchMisses;
+        };
+
+        // the fallback if the counter is unavailable
+        [[nodiscard]] std::string formatCounter(std::optional<f64> value, std::string_view fallback) {
+            if (!value) {
+                return std::string{fallback};
+            }
+
+            return fmt::format("{:.3f}", *value);
+        }
+
+        [[nodiscard]] std::vector<u64> playHistory(Position pos) {
+            std::vector<u64> history{};
+            history.reserve(kHistoryLength);
+
+            // shuffle the first legal move back and forth, which tends to produce some repetitions
+            for (usize ply = 0; ply < kHistoryLength; ++ply) {
+                history.push_back(pos.key());
+
+                movegen::MoveList moves{};
+                movegen::generateAll(moves, pos);
+
+                const auto legal = std::ranges::find_if(moves, [&](Move move) { return pos.isLegal(move); });
+
+                if (legal == moves.end()) {
+                    break;
+                }
+
+                pos = pos.applyMove(*legal);
+            }
+
+            std::ranges::reverse(history);
+
+            return history;
+        }
+
+        void addPosition(Corpus& corpus, const Position& pos) {
+            auto& pseudolegal = corpus.pseudolegalMoves.emplace_back();
+            movegen::generateAll(pseudolegal, pos);
+
+            auto& legal = corpus.legalMoves.emplace_back();
+
+            for (const auto move : pseudolegal) {
+                if (pos.isLegal(move)) {
+                    legal.push_back(move);
+                }
+            }
+
+            corpus.positions.push_back(pos);
+            corpus.keyHistories.push_back(playHistory(pos));
+
+            corpus.totalLegalMoves += legal.size();
+            corpus.totalPseudolegalMoves += pseudolegal.size();
+        }
+
+        [[nodiscard]] Corpus buildCorpus(std::span<const std::string> sfens) {
+            Corpus corpus{};
+
+            for (const auto& sfen : sfens) {
+                const auto root = Position::fromSfen(sfen).take();
+
+                addPosition(corpus, root);
+
+                // copied, as adding positions reallocates the move lists
+                const auto rootMoves = corpus.legalMoves.back();
+
+                for (const auto move : rootMoves) {
+                    addPosition(corpus, root.applyMove(move));
+                }
+            }
+
+            return corpus;
+        }
+
+        usize benchGenerateAll(Context& ctx, u64& sink) {
+            for (const auto& pos : ctx.corpus.positions) {
+                movegen::MoveList moves{};
+                movegen::generateAll(moves, pos);
+                sink += moves.size();
+            }
+
+            return ctx.corpus.positions.size();
+        }
+
+        usize benchGenerateLegal(Context& ctx, u64& sink) {
+            for (const auto& pos : ctx.corpus.positions) {
+                movegen::MoveList moves{};
+                movegen::generateLegal(moves, pos);
+                sink += moves.size();
+            }
+
+            return ctx.corpus.positions.size();
+        }
+
+        usize benchGenerateCaptures(Context& ctx, u64& sink) {
+            for (const auto& pos : ctx.corpus.positions) {
+                movegen::MoveList moves{};
+                movegen::generateCaptures(moves, pos);
+                sink += moves.size();
+            }
+
+            return ctx.corpus.positions.size();
+        }
+
+        usize benchIsLegal(Context& ctx, u64& sink) {
+            const auto& corpus = ctx.corpus;
+
+            for (usize idx = 0; idx < corpus.positions.size(); ++idx) {
+                for (const auto move : corpus.pseudolegalMoves[idx]) {
+                    sink += corpus.positions[idx].isLegal(move);
+                }
+            }
+
+            return corpus.totalPseudolegalMoves;
+        }
+
+        usize benchApplyMove(Context& ctx, u64& sink) {
+            const auto& corpus = ctx.corpus;
+
+            for (usize idx = 0; idx < corpus.positions.size(); ++idx) {
+                for (const auto move : corpus.legalMoves[idx]) {
+                    sink += corpus.positions[idx].applyMove(move).key();
+                }
+            }
+
+            return corpus.totalLegalMoves;
+        }
+
+        usize benchSee(Context& ctx, u64& sink) {
+            const auto& corpus = ctx.corpus;
+
+            for (usize idx = 0; idx < corpus.positions.size(); ++idx) {
+                for (const auto move : corpus.legalMoves[idx]) {
+                    sink += see::see(corpus.positions[idx], move, 0);
+                }
+            }
+
+            return corpus.totalLegalMoves;
+        }
+
+        usize benchTtPut(Context& ctx, u64& sink) {
+            const auto& corpus = ctx.corpus;
+
+            for (usize idx = 0; idx < corpus.positions.size(); ++idx) {
+                const auto& moves = corpus.legalMoves[idx];
+
+                const auto score = static_cast<Score>(idx % 200);
+                const auto move = moves.empty() ? kNullMove : moves[0];
+
+                ctx.ttable.put(corpus.positions[idx].key(), score, move, 8, 0, tt::Flag::kExact, false);
+            }
+
+            sink += corpus.positions.size();
+
+            return corpus.positions.size();
+        }
+
+        usize benchTtProbe(Context& ctx, u64& sink) {
+            tt::ProbedEntry entry{};
+
+            for (const auto& pos : ctx.corpus.positions) {
+                sink += ctx.ttable.probe(entry, pos.key(), 0);
+            }
+
+            return ctx.corpus.positions.size();
+        }
+
+        usize benchNnuePush(Context& ctx, u64& sink) {
+            const auto& corpus = ctx.corpus;
+
+            for (usize idx = 0; idx < corpus.positions.size(); ++idx) {
+                const auto& pos = corpus.positions[idx];
+
+                ctx.nnueState.reset(pos);
+
+                for (const auto move : corpus.legalMoves[idx]) {
+                    sink += pos.applyMove(move, &ctx.nnueState).key();
+                    ctx.nnueState.pop();
+                }
+            }
+
+            return corpus.totalLegalMoves;
+        }
+
+        usize benchNnueReset(Context& ctx, u64& sink) {
+            for (const auto& pos : ctx.corpus.positions) {
+                ctx.nnueState.reset(pos);
+            }
+
+            sink += ctx.corpus.positions.size();
+
+            return ctx.corpus.positions.size();
+        }
+
+        usize benchNnueForward(Context& ctx, u64& sink) {
+            const auto& positions = ctx.corpus.positions;
+
+            // the accumulator's contents make no difference to the cost of a forward pass,
+            // so only refresh it once per pass rather than timing a refresh per position
+            ctx.nnueState.reset(positions[0]);
+
+            for (const auto& pos : positions) {
+                sink += ctx.nnueState.evaluate(pos.stm());
+            }
+
+            return positions.size();
+        }
+
+        usize benchTestSennichite(Context& ctx, u64& sink) {
+            const auto& corpus = ctx.corpus;
+
+            for (usize idx = 0; idx < corpus.positions.size(); ++idx) {
+                const auto status = corpus.positions[idx].testSennichite(false, corpus.keyHistories[idx]);
+                sink += static_cast<u64>(status);
+            }
+
+            return corpus.positions.size();
+        }
+
+        // nnue push includes the cost of applyMove
+        constexpr std::array kComponents = {
+            Component{"generateAll", benchGenerateAll},
+            Component{"generateLegal", benchGenerateLegal},
+            Component{"generateCaptures", benchGenerateCaptures},
+            Component{"isLegal", benchIsLegal},
+            Component{"applyMove", benchApplyMove},
+            Component{"see", benchSee},
+            Component{"ttable put", benchTtPut},
+            Component{"ttable probe", benchTtProbe},
+            Component{"applyMove + nnue push", benchNnuePush},
+            Component{"nnue reset", benchNnueReset},
+            Component{"nnue forward", benchNnueForward},
+            Component{"testSennichite", benchTestSennichite},
+        };
+
+        [[nodiscard]] Result measure(const Component& component, Context& ctx, u32 samples) {
+            u64 sink{};
+
+            // warm up, and find how many passes make a long enough sample
+            usize passes = 1;
+
+            while (true) {
+                const auto start = util::Instant::now();
+
+                for (usize pass = 0; pass < passes; ++pass) {
+                    component.func(ctx, sink);
+                }
+
+                if (start.elapsed() >= kMinSampleTime) {
+                    break;
+                }
+
+                passes *= 2;
+            }
+
+            std::vector<f64> nsPerOp{};
+            nsPerOp.reserve(samples);
+
+            // only counts the timed samples, not the warmup
+            util::PerfCounters counters{};
+
+            usize ops{};
+            usize totalOps{};
+
+            for (u32 sample = 0; sample < samples; ++sample) {
+                ops = 0;
+
+                counters.start();
+                const auto start = util::Instant::now();
+
+                for (usize pass = 0; pass < passes; ++pass) {
+                    ops += component.func(ctx, sink);
+                }
+
+                const auto time = start.elapsed();
+                counters.stop();
+
+                nsPerOp.push_back(time * 1e9 / static_cast<f64>(std::max<usize>(ops, 1)));
+                totalOps += ops;
+            }
+
+            s_sink = s_sink + sink;
+
+            f64 mean{};
+            for (const auto v : nsPerOp) {
+                mean += v;
+            }
+            mean /= static_cast<f64>(nsPerOp.size());
+
+            f64 variance{};
+            for (const auto v : nsPerOp) {
+                variance += (v - mean) * (v - mean);
+            }
+            variance /= static_cast<f64>(std::max<usize>(nsPerOp.size() - 1, 1));
+
+            const auto perOp = [&](util::PerfEvent event) -> std::optional<f64> {
+                if (const auto count = counters.value(event)) {
+                    return static_cast<f64>(*count) / static_cast<f64>(std::max<usize>(totalOps, 1));
+                }
+
+                return {};
+            };
+
+            const auto cycles = counters.value(util::PerfEvent::kCycles);
+            const auto instructions = counters.value(util::PerfEvent::kInstructions);
+
+            std::optional<f64> ipc{};
+
+            if (cycles && instructions && *cycles > 0) {
+                ipc = static_cast<f64>(*instructions) / static_cast<f64>(*cycles);
+            }
+
+            return {
+                .name = component.name,
+                .opsPerSample = ops,
+                .mean = mean,
+                .stddev = std::sqrt(variance),
+                .min = *std::ranges::min_element(nsPerOp),
+                .cycles = perOp(util::PerfEvent::kCycles),
+                .ipc = ipc,
+                .l1dMisses = perOp(util::PerfEvent::kL1dMisses),
+                .llcMisses = perOp(util::PerfEvent::kLlcMisses),
+                .branchMisses = perOp(util::PerfEvent::kBranchMisses),
+            };
+        }
+    } // namespace
+
+    bool run(const MicrobenchConfig& config) {
+        const auto sfens = bench::loadSfens(config.sfenFile);
+
+        if (!sfens) {
+            return false;
+        }
+
+        Context ctx{};
+
+        ctx.corpus = buildCorpus(*sfens);
+        ctx.ttable.finalize();
+
+        const auto& corpus = ctx.corpus;
+
+        const auto samples = std::max<u32>(config.samples, 2);
+
+        // only checks whether counters can be opened at all, each component opens its own
+        const util::PerfCounters probe{};
+
+        if (config.csv) {
+            fmt::println(
+                "name,samples,ops_per_sample,mean_ns,stddev_ns,min_ns,"
+                "cycles,ipc,l1d_misses,llc_misses,branch_misses"
+            );
+        } else {
+            fmt::println(
+                "{} positions, {} legal moves, {} samples per component",
+                corpus.positions.size(),
+                corpus.totalLegalMoves,
+                samples
+            );
+            fmt::println("");
+            fmt::println(
+                "{:<22} {:>12} {:>10} {:>10} {:>10} {:>10} {:>7} {:>10} {:>10} {:>10}",
+                "component",
+                "ops/sample",
+                "mean ns",
+                "stddev",
+                "min ns",
+                "cycles",
+                "ipc",
+                "l1d miss",
+                "llc miss",
+                "br miss"
+            );
+        }
+
+        for (const auto& component : kComponents) {
+            const auto result = measure(component, ctx, samples);
+
+            if (config.csv) {
+                fmt::println(
+                    "{},{},{},{:.3f},{:.3f},{:.3f},{},{},{},{},{}",
+                    result.name,
+                    samples,
+                    result.opsPerSample,
+                    result.mean,
+                    result.stddev,
+                    result.min,
+                    formatCounter(result.cycles, ""),
+                    formatCounter(result.ipc, ""),
+                    formatCounter(result.l1dMisses, ""),
+                    formatCounter(result.llcMisses, ""),
+                    formatCounter(result.branchMisses, "")
+                );
+            } else {
+                fmt::println(
+                    "{:<22} {:>12} {:>10.2f} {:>10.2f} {:>10.2f} {:>10} {:>7} {:>10} {:>10} {:>10}",
+                    result.name,
+                    result.opsPerSample,
+                    result.mean,
+                    result.stddev,
+                    result.min,
+                    formatCounter(result.cycles, "-"),
+                    formatCounter(result.ipc, "-"),
+                    formatCounter(result.l1dMisses, "-"),
+                    formatCounter(result.llcMisses, "-"),
+                    formatCounter(result.branchMisses, "-")
+                );
+            }
+        }
+
+        if (!config.csv && !probe.available()) {
+            fmt::println("");
+            // prints why the counters could not be opened
+            probe.print(0);
+        }
+
+        return true;
+    }
+} // namespace stoat::microbench
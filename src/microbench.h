@@ -0,0 +1,40 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "types.h"
+
+#include <string>
+
+namespace stoat::microbench {
+    constexpr u32 kDefaultSamples = 10;
+
+    struct MicrobenchConfig {
+        u32 samples{kDefaultSamples};
+        bool csv{false};
+        // see bench::loadSfens
+        std::string sfenFile{};
+    };
+
+    // times the search's building blocks in isolation over the sfens and
+    // every position one move away from them, reporting ns per operation
+    // and, where the hardware counters can be opened, cycles, ipc and misses
+    bool run(const MicrobenchConfig& config = {});
+} // namespace stoat::microbench
@@ -62,7 +62,25 @@ namespace stoat::movegen {
             }
         }
 
-        template <bool kCanPromote>
+        // the generators below are specialised on the side to move. Color is not a structural
+        // type, so it is passed by its raw id, and the public functions dispatch on it once
+
+        // squares a piece may move to without exposing its own king. a pinned piece
+        // can only move along its pin ray, and never resolves a check
+        template <bool kLegal, u8 kStm>
+        [[nodiscard]] inline Bitboard pinMask(const Position& pos, Square sq) {
+            constexpr auto stm = Color::fromRaw(kStm);
+
+            if constexpr (kLegal) {
+                if (pos.pinned().getSquare(sq)) {
+                    return pos.isInCheck() ? Bitboards::kEmpty : rayIntersecting(sq, pos.kingSq(stm));
+                }
+            }
+
+            return Bitboards::kAll;
+        }
+
+        template <bool kCanPromote, bool kLegal, u8 kStm>
         void generatePrecalculatedWithColorAndOcc(
             MoveList& dst,
             const Position& pos,
@@ -71,7 +89,7 @@ namespace stoat::movegen {
             Bitboard dstMask,
             Bitboard nonPromoMask = Bitboards::kAll
         ) {
-            const auto stm = pos.stm();
+            constexpr auto stm = Color::fromRaw(kStm);
 
             const auto occ = pos.occupancy();
 
@@ -81,7 +99,8 @@ namespace stoat::movegen {
                 auto promotable = pieces;
                 while (!promotable.empty()) {
                     const auto piece = promotable.popLsb();
-                    const auto attacks = attackGetter(piece, pos.stm(), occ) & dstMask & promoArea;
+                    const auto attacks =
+                        attackGetter(piece, stm, occ) & dstMask & promoArea & pinMask<kLegal, kStm>(pos, piece);
 
                     serializePromotions(dst, piece, attacks);
                 }
@@ -89,7 +108,8 @@ namespace stoat::movegen {
                 promotable = pieces & promoArea;
                 while (!promotable.empty()) {
                     const auto piece = promotable.popLsb();
-                    const auto attacks = attackGetter(piece, pos.stm(), occ) & dstMask & ~promoArea;
+                    const auto attacks =
+                        attackGetter(piece, stm, occ) & dstMask & ~promoArea & pinMask<kLegal, kStm>(pos, piece);
 
                     serializePromotions(dst, piece, attacks);
                 }
@@ -98,13 +118,14 @@ namespace stoat::movegen {
             auto movable = pieces;
             while (!movable.empty()) {
                 const auto piece = movable.popLsb();
-                const auto attacks = attackGetter(piece, pos.stm(), occ) & dstMask & nonPromoMask;
+                const auto attacks =
+                    attackGetter(piece, stm, occ) & dstMask & nonPromoMask & pinMask<kLegal, kStm>(pos, piece);
 
                 serializeNormals(dst, piece, attacks);
             }
         }
 
-        template <bool kCanPromote>
+        template <bool kCanPromote, bool kLegal, u8 kStm>
         void generatePrecalculatedWithColor(
             MoveList& dst,
             const Position& pos,
@@ -113,7 +134,7 @@ namespace stoat::movegen {
             Bitboard dstMask,
             Bitboard nonPromoMask = Bitboards::kAll
         ) {
-            generatePrecalculatedWithColorAndOcc<kCanPromote>(
+            generatePrecalculatedWithColorAndOcc<kCanPromote, kLegal, kStm>(
                 dst,
                 pos,
                 pieces,
@@ -123,7 +144,7 @@ namespace stoat::movegen {
             );
         }
 
-        template <bool kCanPromote>
+        template <bool kCanPromote, bool kLegal, u8 kStm>
         void generatePrecalculatedWithOcc(
             MoveList& dst,
             const Position& pos,
@@ -132,7 +153,7 @@ namespace stoat::movegen {
             Bitboard dstMask,
             Bitboard nonPromoMask = Bitboards::kAll
         ) {
-            generatePrecalculatedWithColorAndOcc<kCanPromote>(
+            generatePrecalculatedWithColorAndOcc<kCanPromote, kLegal, kStm>(
                 dst,
                 pos,
                 pieces,
@@ -142,30 +163,27 @@ namespace stoat::movegen {
             );
         }
 
-        template <bool kCanPromote>
-        void generatePrecalculated(
-            MoveList& dst,
-            const Position& pos,
-            Bitboard pieces,
-            auto attackGetter,
-            Bitboard dstMask,
-            Bitboard nonPromoMask = Bitboards::kAll
-        ) {
-            generatePrecalculatedWithColorAndOcc<kCanPromote>(
-                dst,
-                pos,
-                pieces,
-                [&](Square sq, Color c, Bitboard occ) { return attackGetter(sq); },
-                dstMask,
-                nonPromoMask
-            );
-        }
-
+        template <bool kLegal, u8 kStm>
         void generatePawns(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            const auto stm = pos.stm();
+            constexpr auto stm = Color::fromRaw(kStm);
             const auto pawns = pos.pieceBb(PieceTypes::kPawn, stm);
 
-            const auto shifted = pawns.shiftNorthRelative(stm) & dstMask;
+            auto shifted = pawns.shiftNorthRelative(stm) & dstMask;
+
+            if constexpr (kLegal) {
+                auto pinnedPawns = pawns & pos.pinned();
+
+                if (!pinnedPawns.empty()) {
+                    auto allowed = (pawns & ~pos.pinned()).shiftNorthRelative(stm);
+
+                    while (!pinnedPawns.empty()) {
+                        const auto pawn = pinnedPawns.popLsb();
+                        allowed |= Bitboard::fromSquare(pawn).shiftNorthRelative(stm) & pinMask<true, kStm>(pos, pawn);
+                    }
+
+                    shifted &= allowed;
+                }
+            }
 
             const auto promos = shifted & Bitboards::promoArea(stm);
             const auto nonPromos = shifted & ~Bitboards::relativeRank(stm, 8);
@@ -176,75 +194,108 @@ namespace stoat::movegen {
             serializeNormals(dst, offset, nonPromos);
         }
 
+        template <bool kLegal, u8 kStm>
         void generateLances(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            const auto lances = pos.pieceBb(PieceTypes::kLance, pos.stm());
-            generatePrecalculatedWithColorAndOcc<true>(
+            constexpr auto stm = Color::fromRaw(kStm);
+            const auto lances = pos.pieceBb(PieceTypes::kLance, stm);
+            generatePrecalculatedWithColorAndOcc<true, kLegal, kStm>(
                 dst,
                 pos,
                 lances,
                 attacks::lanceAttacks,
                 dstMask,
-                ~Bitboards::relativeRank(pos.stm(), 8)
+                ~Bitboards::relativeRank(stm, 8)
             );
         }
 
+        template <bool kLegal, u8 kStm>
         void generateKnights(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            const auto knights = pos.pieceBb(PieceTypes::kKnight, pos.stm());
-            generatePrecalculatedWithColor<true>(
+            constexpr auto stm = Color::fromRaw(kStm);
+            const auto knights = pos.pieceBb(PieceTypes::kKnight, stm);
+            generatePrecalculatedWithColor<true, kLegal, kStm>(
                 dst,
                 pos,
                 knights,
                 attacks::knightAttacks,
                 dstMask,
-                ~(Bitboards::relativeRank(pos.stm(), 8) | Bitboards::relativeRank(pos.stm(), 7))
+                ~(Bitboards::relativeRank(stm, 8) | Bitboards::relativeRank(stm, 7))
             );
         }
 
+        template <bool kLegal, u8 kStm>
         void generateSilvers(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            const auto silvers = pos.pieceBb(PieceTypes::kSilver, pos.stm());
-            generatePrecalculatedWithColor<true>(dst, pos, silvers, attacks::silverAttacks, dstMask);
+            constexpr auto stm = Color::fromRaw(kStm);
+            const auto silvers = pos.pieceBb(PieceTypes::kSilver, stm);
+            generatePrecalculatedWithColor<true, kLegal, kStm>(dst, pos, silvers, attacks::silverAttacks, dstMask);
         }
 
+        template <bool kLegal, u8 kStm>
         void generateGolds(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            const auto golds = pos.pieceBb(PieceTypes::kGold, pos.stm())
-                             | pos.pieceBb(PieceTypes::kPromotedPawn, pos.stm())
-                             | pos.pieceBb(PieceTypes::kPromotedLance, pos.stm())
-                             | pos.pieceBb(PieceTypes::kPromotedKnight, pos.stm())
-                             | pos.pieceBb(PieceTypes::kPromotedSilver, pos.stm());
-            generatePrecalculatedWithColor<false>(dst, pos, golds, attacks::goldAttacks, dstMask);
+            constexpr auto stm = Color::fromRaw(kStm);
+            const auto golds = pos.pieceBb(PieceTypes::kGold, stm)
+                             | pos.pieceBb(PieceTypes::kPromotedPawn, stm)
+                             | pos.pieceBb(PieceTypes::kPromotedLance, stm)
+                             | pos.pieceBb(PieceTypes::kPromotedKnight, stm)
+                             | pos.pieceBb(PieceTypes::kPromotedSilver, stm);
+            generatePrecalculatedWithColor<false, kLegal, kStm>(dst, pos, golds, attacks::goldAttacks, dstMask);
         }
 
+        template <bool kLegal, u8 kStm>
         void generateBishops(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            const auto bishops = pos.pieceBb(PieceTypes::kBishop, pos.stm());
-            generatePrecalculatedWithOcc<true>(dst, pos, bishops, attacks::bishopAttacks, dstMask);
+            constexpr auto stm = Color::fromRaw(kStm);
+            const auto bishops = pos.pieceBb(PieceTypes::kBishop, stm);
+            generatePrecalculatedWithOcc<true, kLegal, kStm>(dst, pos, bishops, attacks::bishopAttacks, dstMask);
         }
 
+        template <bool kLegal, u8 kStm>
         void generateRooks(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            const auto rooks = pos.pieceBb(PieceTypes::kRook, pos.stm());
-            generatePrecalculatedWithOcc<true>(dst, pos, rooks, attacks::rookAttacks, dstMask);
+            constexpr auto stm = Color::fromRaw(kStm);
+            const auto rooks = pos.pieceBb(PieceTypes::kRook, stm);
+            generatePrecalculatedWithOcc<true, kLegal, kStm>(dst, pos, rooks, attacks::rookAttacks, dstMask);
         }
 
+        template <bool kLegal, u8 kStm>
         void generatePromotedBishops(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            const auto horses = pos.pieceBb(PieceTypes::kPromotedBishop, pos.stm());
-            generatePrecalculatedWithOcc<false>(dst, pos, horses, attacks::promotedBishopAttacks, dstMask);
+            constexpr auto stm = Color::fromRaw(kStm);
+            const auto horses = pos.pieceBb(PieceTypes::kPromotedBishop, stm);
+            generatePrecalculatedWithOcc<false, kLegal, kStm>(
+                dst,
+                pos,
+                horses,
+                attacks::promotedBishopAttacks,
+                dstMask
+            );
         }
 
+        template <bool kLegal, u8 kStm>
         void generatePromotedRooks(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            const auto dragons = pos.pieceBb(PieceTypes::kPromotedRook, pos.stm());
-            generatePrecalculatedWithOcc<false>(dst, pos, dragons, attacks::promotedRookAttacks, dstMask);
+            constexpr auto stm = Color::fromRaw(kStm);
+            const auto dragons = pos.pieceBb(PieceTypes::kPromotedRook, stm);
+            generatePrecalculatedWithOcc<false, kLegal, kStm>(dst, pos, dragons, attacks::promotedRookAttacks, dstMask);
         }
 
+        template <bool kLegal, u8 kStm>
         void generateKings(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            const auto kings = pos.pieceBb(PieceTypes::kKing, pos.stm());
-            generatePrecalculated<false>(dst, pos, kings, attacks::kingAttacks, dstMask);
+            constexpr auto stm = Color::fromRaw(kStm);
+            const auto king = pos.kingSq(stm);
+
+            auto targets = attacks::kingAttacks(king) & dstMask;
+
+            if constexpr (kLegal) {
+                targets &= ~pos.threats();
+            }
+
+            serializeNormals(dst, king, targets);
         }
 
-        void generateDrops(MoveList& dst, const Position& pos, Bitboard dstMask) {
+        // pieceMask further restricts the targets of each piece type
+        template <bool kLegal, u8 kStm>
+        void generateDrops(MoveList& dst, const Position& pos, Bitboard dstMask, auto pieceMask) {
             if (dstMask.empty()) {
                 return;
             }
 
-            const auto stm = pos.stm();
+            constexpr auto stm = Color::fromRaw(kStm);
             const auto& hand = pos.hand(stm);
 
             if (hand.empty()) {
@@ -253,15 +304,27 @@ namespace stoat::movegen {
 
             const auto generate = [&](PieceType pt, Bitboard restriction = Bitboards::kAll) {
                 if (hand.count(pt) > 0) {
-                    const auto targets = dstMask & restriction;
+                    const auto targets = dstMask & restriction & pieceMask(pt);
                     serializeDrops(dst, pt, targets);
                 }
             };
 
-            generate(
-                PieceTypes::kPawn,
-                ~Bitboards::relativeRank(stm, 8) & ~pos.pieceBb(PieceTypes::kPawn, stm).fillFile()
-            );
+            auto pawnRestriction = ~Bitboards::relativeRank(stm, 8) & ~pos.pieceBb(PieceTypes::kPawn, stm).fillFile();
+
+            if constexpr (kLegal) {
+                // the one square where a pawn drop gives check, which is illegal if it mates
+                const auto checkSquare = pos.pieceBb(PieceTypes::kKing, stm.flip()).shiftSouthRelative(stm);
+
+                if (hand.count(PieceTypes::kPawn) > 0
+                    && !(checkSquare & dstMask & pawnRestriction & pieceMask(PieceTypes::kPawn)).empty())
+                {
+                    if (!pos.isLegal(Move::makeDrop(PieceTypes::kPawn, checkSquare.lsb()))) {
+                        pawnRestriction &= ~checkSquare;
+                    }
+                }
+            }
+
+            generate(PieceTypes::kPawn, pawnRestriction);
             generate(PieceTypes::kLance, ~Bitboards::relativeRank(stm, 8));
             generate(PieceTypes::kKnight, ~(Bitboards::relativeRank(stm, 8) | Bitboards::relativeRank(stm, 7)));
             generate(PieceTypes::kSilver);
@@ -270,9 +333,16 @@ namespace stoat::movegen {
             generate(PieceTypes::kRook);
         }
 
-        template <bool kGenerateDrops>
+        template <bool kLegal, u8 kStm>
+        void generateDrops(MoveList& dst, const Position& pos, Bitboard dstMask) {
+            generateDrops<kLegal, kStm>(dst, pos, dstMask, [](PieceType) { return Bitboards::kAll; });
+        }
+
+        template <bool kGenerateDrops, bool kLegal, u8 kStm>
         void generate(MoveList& dst, const Position& pos, Bitboard dstMask) {
-            generateKings(dst, pos, dstMask);
+            constexpr auto stm = Color::fromRaw(kStm);
+
+            generateKings<kLegal, kStm>(dst, pos, dstMask);
 
             if (pos.checkers().multiple()) {
                 return;
@@ -282,41 +352,247 @@ namespace stoat::movegen {
 
             if (!pos.checkers().empty()) {
                 const auto checker = pos.checkers().lsb();
-                const auto checkRay = rayBetween(pos.kingSq(pos.stm()), checker);
+                const auto checkRay = rayBetween(pos.kingSq(stm), checker);
 
                 dstMask &= checkRay | checker.bit();
                 dropMask &= checkRay;
             }
 
-            generatePawns(dst, pos, dstMask);
-            generateLances(dst, pos, dstMask);
-            generateKnights(dst, pos, dstMask);
-            generateSilvers(dst, pos, dstMask);
-            generateGolds(dst, pos, dstMask);
-            generateBishops(dst, pos, dstMask);
-            generateRooks(dst, pos, dstMask);
-            generatePromotedBishops(dst, pos, dstMask);
-            generatePromotedRooks(dst, pos, dstMask);
+            generatePawns<kLegal, kStm>(dst, pos, dstMask);
+            generateLances<kLegal, kStm>(dst, pos, dstMask);
+            generateKnights<kLegal, kStm>(dst, pos, dstMask);
+            generateSilvers<kLegal, kStm>(dst, pos, dstMask);
+            generateGolds<kLegal, kStm>(dst, pos, dstMask);
+            generateBishops<kLegal, kStm>(dst, pos, dstMask);
+            generateRooks<kLegal, kStm>(dst, pos, dstMask);
+            generatePromotedBishops<kLegal, kStm>(dst, pos, dstMask);
+            generatePromotedRooks<kLegal, kStm>(dst, pos, dstMask);
 
             if constexpr (kGenerateDrops) {
-                generateDrops(dst, pos, dropMask);
+                generateDrops<kLegal, kStm>(dst, pos, dropMask);
+            }
+        }
+
+        // pieces of the side to move that give discovered check when moving off their line to the enemy king
+        template <u8 kStm>
+        [[nodiscard]] Bitboard discoverers(const Position& pos) {
+            constexpr auto stm = Color::fromRaw(kStm);
+            constexpr auto nstm = stm.flip();
+
+            const auto theirKing = pos.kingSq(nstm);
+
+            const auto stmOcc = pos.colorBb(stm);
+            const auto nstmOcc = pos.colorBb(nstm);
+
+            const auto stmLances = pos.pieceBb(PieceTypes::kLance, stm);
+            const auto stmBishops = pos.pieceBb(PieceTypes::kBishop, stm) | pos.pieceBb(PieceTypes::kPromotedBishop, stm);
+            const auto stmRooks = pos.pieceBb(PieceTypes::kRook, stm) | pos.pieceBb(PieceTypes::kPromotedRook, stm);
+
+            Bitboard result{};
+
+            auto sliders = (attacks::lanceAttacks(theirKing, nstm, nstmOcc) & stmLances)
+                         | (attacks::bishopAttacks(theirKing, nstmOcc) & stmBishops)
+                         | (attacks::rookAttacks(theirKing, nstmOcc) & stmRooks);
+            while (!sliders.empty()) {
+                const auto slider = sliders.popLsb();
+                const auto blockers = stmOcc & rayBetween(slider, theirKing);
+
+                if (blockers.one()) {
+                    result |= blockers;
+                }
+            }
+
+            return result;
+        }
+
+        [[nodiscard]] constexpr Bitboard nonPromoMask(PieceType pt, Color c) {
+            switch (pt.raw()) {
+                case PieceTypes::kPawn.raw():
+                case PieceTypes::kLance.raw():
+                    return ~Bitboards::relativeRank(c, 8);
+                case PieceTypes::kKnight.raw():
+                    return ~(Bitboards::relativeRank(c, 8) | Bitboards::relativeRank(c, 7));
+                default:
+                    return Bitboards::kAll;
+            }
+        }
+
+        template <bool kPromos, u8 kStm>
+        void generateChecksFrom(MoveList& dst, const Position& pos, Square from, Bitboard dstMask, Bitboard discovered) {
+            constexpr auto stm = Color::fromRaw(kStm);
+            constexpr auto nstm = stm.flip();
+
+            const auto theirKing = pos.kingSq(nstm);
+
+            const auto occ = pos.occupancy();
+            const auto pt = pos.pieceOn(from).type();
+
+            const auto targets = attacks::pieceAttacks(pt, from, stm, occ) & dstMask & pinMask<true, kStm>(pos, from);
+
+            if (targets.empty()) {
+                return;
+            }
+
+            // any move off the line to the enemy king gives check, whatever the piece becomes
+            const auto discovering =
+                discovered.getSquare(from) ? targets & ~rayIntersecting(from, theirKing) : Bitboards::kEmpty;
+
+            // the piece no longer blocks its own line to the king once it has moved
+            const auto vacated = occ ^ Bitboard::fromSquare(from);
+
+            if constexpr (kPromos) {
+                if (pt.canPromote()) {
+                    const auto promoArea = Bitboards::promoArea(stm);
+
+                    const auto promoTargets = promoArea.getSquare(from) ? targets : targets & promoArea;
+                    const auto checkSquares = attacks::pieceAttacks(pt.promoted(), theirKing, nstm, vacated);
+
+                    serializePromotions(dst, from, promoTargets & (checkSquares | discovering));
+                }
+            } else {
+                const auto checkSquares = attacks::pieceAttacks(pt, theirKing, nstm, vacated);
+                serializeNormals(dst, from, targets & nonPromoMask(pt, stm) & (checkSquares | discovering));
+            }
+        }
+
+        template <u8 kStm>
+        void generateChecksForStm(MoveList& dst, const Position& pos) {
+            constexpr auto stm = Color::fromRaw(kStm);
+            constexpr auto nstm = stm.flip();
+
+            const auto king = pos.kingSq(stm);
+            const auto theirKing = pos.kingSq(nstm);
+
+            const auto occ = pos.occupancy();
+            const auto discovered = discoverers<kStm>(pos);
+
+            auto dstMask = ~pos.colorBb(stm);
+
+            // a king can only give discovered check
+            if (discovered.getSquare(king)) {
+                generateKings<true, kStm>(dst, pos, dstMask & ~rayIntersecting(king, theirKing));
+            }
+
+            if (pos.checkers().multiple()) {
+                return;
+            }
+
+            auto dropMask = ~occ;
+
+            if (!pos.checkers().empty()) {
+                const auto checker = pos.checkers().lsb();
+                const auto checkRay = rayBetween(king, checker);
+
+                dstMask &= checkRay | checker.bit();
+                dropMask &= checkRay;
+            }
+
+            // same piece order as generateAll, with each piece type's promotions first
+            const auto generatePieces = [&](Bitboard pieces) {
+                auto promotable = pieces;
+                while (!promotable.empty()) {
+                    generateChecksFrom<true, kStm>(dst, pos, promotable.popLsb(), dstMask, discovered);
+                }
+
+                while (!pieces.empty()) {
+                    generateChecksFrom<false, kStm>(dst, pos, pieces.popLsb(), dstMask, discovered);
+                }
+            };
+
+            generatePieces(pos.pieceBb(PieceTypes::kPawn, stm));
+            generatePieces(pos.pieceBb(PieceTypes::kLance, stm));
+            generatePieces(pos.pieceBb(PieceTypes::kKnight, stm));
+            generatePieces(pos.pieceBb(PieceTypes::kSilver, stm));
+            generatePieces(
+                pos.pieceBb(PieceTypes::kGold, stm) | pos.pieceBb(PieceTypes::kPromotedPawn, stm)
+                | pos.pieceBb(PieceTypes::kPromotedLance, stm) | pos.pieceBb(PieceTypes::kPromotedKnight, stm)
+                | pos.pieceBb(PieceTypes::kPromotedSilver, stm)
+            );
+            generatePieces(pos.pieceBb(PieceTypes::kBishop, stm));
+            generatePieces(pos.pieceBb(PieceTypes::kRook, stm));
+            generatePieces(pos.pieceBb(PieceTypes::kPromotedBishop, stm));
+            generatePieces(pos.pieceBb(PieceTypes::kPromotedRook, stm));
+
+            generateDrops<true, kStm>(dst, pos, dropMask, [&](PieceType pt) {
+                return attacks::pieceAttacks(pt, theirKing, nstm, occ);
+            });
+        }
+
+        template <u8 kStm>
+        void generateEvasionsForStm(MoveList& dst, const Position& pos) {
+            constexpr auto stm = Color::fromRaw(kStm);
+            const auto king = pos.kingSq(stm);
+
+            const auto dstMask = ~pos.colorBb(stm);
+
+            generateKings<true, kStm>(dst, pos, dstMask);
+
+            // multiple checks can only be evaded with a king move
+            if (pos.checkers().multiple()) {
+                return;
+            }
+
+            const auto checker = pos.checkers().lsb();
+            const auto checkRay = rayBetween(king, checker);
+
+            const auto blockMask = dstMask & (checkRay | Bitboard::fromSquare(checker));
+
+            // no pinned piece can block or capture, so only generate moves for the rest.
+            // the pin masks are still applied, but come out empty
+            generatePawns<true, kStm>(dst, pos, blockMask);
+            generateLances<true, kStm>(dst, pos, blockMask);
+            generateKnights<true, kStm>(dst, pos, blockMask);
+            generateSilvers<true, kStm>(dst, pos, blockMask);
+            generateGolds<true, kStm>(dst, pos, blockMask);
+            generateBishops<true, kStm>(dst, pos, blockMask);
+            generateRooks<true, kStm>(dst, pos, blockMask);
+            generatePromotedBishops<true, kStm>(dst, pos, blockMask);
+            generatePromotedRooks<true, kStm>(dst, pos, blockMask);
+
+            generateDrops<true, kStm>(dst, pos, checkRay & ~pos.occupancy());
+        }
+
+        template <u8 kStm>
+        void generateLegalDropsForStm(MoveList& dst, const Position& pos) {
+            constexpr auto stm = Color::fromRaw(kStm);
+
+            // multiple checks can only be evaded with a king move
+            if (pos.checkers().multiple()) {
+                return;
+            }
+
+            auto dropMask = ~pos.occupancy();
+
+            if (!pos.checkers().empty()) {
+                dropMask &= rayBetween(pos.kingSq(stm), pos.checkers().lsb());
+            }
+
+            generateDrops<true, kStm>(dst, pos, dropMask);
+        }
+
+        template <bool kGenerateDrops, bool kLegal>
+        void generateForStm(MoveList& dst, const Position& pos, Bitboard dstMask) {
+            if (pos.stm() == Colors::kBlack) {
+                generate<kGenerateDrops, kLegal, Colors::kBlack.raw()>(dst, pos, dstMask);
+            } else {
+                generate<kGenerateDrops, kLegal, Colors::kWhite.raw()>(dst, pos, dstMask);
             }
         }
     } // namespace
 
     void generateAll(MoveList& dst, const Position& pos) {
         const auto dstMask = ~pos.colorBb(pos.stm());
-        generate<true>(dst, pos, dstMask);
+        generateForStm<true, false>(dst, pos, dstMask);
     }
 
     void generateCaptures(MoveList& dst, const Position& pos) {
         const auto dstMask = pos.colorBb(pos.stm().flip());
-        generate<false>(dst, pos, dstMask);
+        generateForStm<false, false>(dst, pos, dstMask);
     }
 
     void generateNonCaptures(MoveList& dst, const Position& pos) {
         const auto dstMask = ~pos.occupancy();
-        generate<true>(dst, pos, dstMask);
+        generateForStm<true, false>(dst, pos, dstMask);
     }
 
     void generateRecaptures(MoveList& dst, const Position& pos, Square captureSq) {
@@ -324,6 +600,52 @@ namespace stoat::movegen {
         assert(pos.colorBb(pos.stm().flip()).getSquare(captureSq));
 
         const auto dstMask = Bitboard::fromSquare(captureSq);
-        generate<false>(dst, pos, dstMask);
+        generateForStm<false, false>(dst, pos, dstMask);
+    }
+
+    void generateLegal(MoveList& dst, const Position& pos) {
+        const auto dstMask = ~pos.colorBb(pos.stm());
+        generateForStm<true, true>(dst, pos, dstMask);
+    }
+
+    void generateLegalCaptures(MoveList& dst, const Position& pos) {
+        const auto dstMask = pos.colorBb(pos.stm().flip());
+        generateForStm<false, true>(dst, pos, dstMask);
+    }
+
+    void generateLegalNonCaptures(MoveList& dst, const Position& pos) {
+        const auto dstMask = ~pos.occupancy();
+        generateForStm<true, true>(dst, pos, dstMask);
+    }
+
+    void generateLegalBoardNonCaptures(MoveList& dst, const Position& pos) {
+        const auto dstMask = ~pos.occupancy();
+        generateForStm<false, true>(dst, pos, dstMask);
+    }
+
+    void generateLegalDrops(MoveList& dst, const Position& pos) {
+        if (pos.stm() == Colors::kBlack) {
+            generateLegalDropsForStm<Colors::kBlack.raw()>(dst, pos);
+        } else {
+            generateLegalDropsForStm<Colors::kWhite.raw()>(dst, pos);
+        }
+    }
+
+    void generateChecks(MoveList& dst, const Position& pos) {
+        if (pos.stm() == Colors::kBlack) {
+            generateChecksForStm<Colors::kBlack.raw()>(dst, pos);
+        } else {
+            generateChecksForStm<Colors::kWhite.raw()>(dst, pos);
+        }
+    }
+
+    void generateEvasions(MoveList& dst, const Position& pos) {
+        assert(pos.isInCheck());
+
+        if (pos.stm() == Colors::kBlack) {
+            generateEvasionsForStm<Colors::kBlack.raw()>(dst, pos);
+        } else {
+            generateEvasionsForStm<Colors::kWhite.raw()>(dst, pos);
+        }
     }
 } // namespace stoat::movegen
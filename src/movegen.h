@@ -32,4 +32,19 @@ namespace stoat::movegen {
     void generateCaptures(MoveList& dst, const Position& pos);
     void generateNonCaptures(MoveList& dst, const Position& pos);
     void generateRecaptures(MoveList& dst, const Position& pos, Square captureSq);
+
+    // fully legal variants, no isLegal check required on the generated moves
+    void generateLegal(MoveList& dst, const Position& pos);
+    void generateLegalCaptures(MoveList& dst, const Position& pos);
+    void generateLegalNonCaptures(MoveList& dst, const Position& pos);
+
+    // generateLegalNonCaptures split into moves of pieces on the board and drops, in the same order
+    void generateLegalBoardNonCaptures(MoveList& dst, const Position& pos);
+    void generateLegalDrops(MoveList& dst, const Position& pos);
+
+    // legal moves that give check, including discovered checks
+    void generateChecks(MoveList& dst, const Position& pos);
+
+    // legal moves out of check, only valid while in check
+    void generateEvasions(MoveList& dst, const Position& pos);
 } // namespace stoat::movegen
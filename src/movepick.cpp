@@ -21,12 +21,17 @@
 #include "see.h"
 
 namespace stoat {
+    namespace {
+        // non-captures scoring below this are left unsorted
+        constexpr i32 kNonCaptureSortThreshold = -8192;
+    } // namespace
+
     Move MoveGenerator::next() {
         switch (m_stage) {
             case MovegenStage::kTtMove: {
                 ++m_stage;
 
-                if (m_ttMove && m_pos.isPseudolegal(m_ttMove)) {
+                if (m_ttMove && m_pos.isPseudolegal(m_ttMove) && m_pos.isLegal(m_ttMove)) {
                     return m_ttMove;
                 }
 
@@ -34,7 +39,7 @@ namespace stoat {
             }
 
             case MovegenStage::kGenerateCaptures: {
-                movegen::generateCaptures(m_moves, m_pos);
+                movegen::generateLegalCaptures(m_moves, m_pos);
                 m_end = m_moves.size();
 
                 scoreCaptures();
@@ -65,11 +70,12 @@ namespace stoat {
 
             case MovegenStage::kGenerateNonCaptures: {
                 if (!m_skipNonCaptures) {
-                    movegen::generateNonCaptures(m_moves, m_pos);
+                    movegen::generateLegalBoardNonCaptures(m_moves, m_pos);
                     m_end = m_moves.size();
-                }
 
-                scoreNonCaptures();
+                    scoreNonCaptures();
+                    partialSort(kNonCaptureSortThreshold);
+                }
 
                 ++m_stage;
                 [[fallthrough]];
@@ -77,7 +83,33 @@ namespace stoat {
 
             case MovegenStage::kNonCaptures: {
                 if (!m_skipNonCaptures) {
-                    if (const auto move = selectNext([this](Move move) { return move != m_ttMove; })) {
+                    if (const auto move = selectNext<false>([this](Move move) { return move != m_ttMove; })) {
+                        return move;
+                    }
+                }
+
+                ++m_stage;
+                [[fallthrough]];
+            }
+
+            // drops are often the bulk of the non-captures, so they are
+            // only generated once the moves on the board have not cut off
+            case MovegenStage::kGenerateDrops: {
+                if (!m_skipNonCaptures) {
+                    movegen::generateLegalDrops(m_moves, m_pos);
+                    m_end = m_moves.size();
+
+                    scoreNonCaptures();
+                    partialSort(kNonCaptureSortThreshold);
+                }
+
+                ++m_stage;
+                [[fallthrough]];
+            }
+
+            case MovegenStage::kDrops: {
+                if (!m_skipNonCaptures) {
+                    if (const auto move = selectNext<false>([this](Move move) { return move != m_ttMove; })) {
                         return move;
                     }
                 }
@@ -99,7 +131,7 @@ namespace stoat {
             }
 
             case MovegenStage::kQsearchGenerateCaptures: {
-                movegen::generateCaptures(m_moves, m_pos);
+                movegen::generateLegalCaptures(m_moves, m_pos);
                 m_end = m_moves.size();
 
                 scoreCaptures();
@@ -118,7 +150,7 @@ namespace stoat {
             }
 
             case MovegenStage::kQsearchEvasionsGenerateCaptures: {
-                movegen::generateCaptures(m_moves, m_pos);
+                movegen::generateLegalCaptures(m_moves, m_pos);
                 m_end = m_moves.size();
 
                 scoreCaptures();
@@ -138,7 +170,7 @@ namespace stoat {
 
             case MovegenStage::kQsearchEvasionsGenerateNonCaptures: {
                 if (!m_skipNonCaptures) {
-                    movegen::generateNonCaptures(m_moves, m_pos);
+                    movegen::generateLegalNonCaptures(m_moves, m_pos);
                     m_end = m_moves.size();
                 }
 
@@ -241,4 +273,32 @@ namespace stoat {
 
         return m_idx++;
     }
+
+    void MoveGenerator::partialSort(i32 threshold) {
+        auto sortedEnd = m_idx;
+
+        // insertion sort of only the moves scoring at least the threshold, which end up in front of the rest
+        for (usize idx = m_idx; idx < m_end; ++idx) {
+            const auto move = m_moves[idx];
+            const auto score = m_scores[idx];
+
+            if (score < threshold) {
+                continue;
+            }
+
+            m_moves[idx] = m_moves[sortedEnd];
+            m_scores[idx] = m_scores[sortedEnd];
+
+            auto insertIdx = sortedEnd++;
+
+            while (insertIdx > m_idx && m_scores[insertIdx - 1] < score) {
+                m_moves[insertIdx] = m_moves[insertIdx - 1];
+                m_scores[insertIdx] = m_scores[insertIdx - 1];
+                --insertIdx;
+            }
+
+            m_moves[insertIdx] = move;
+            m_scores[insertIdx] = score;
+        }
+    }
 } // namespace stoat
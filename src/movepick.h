@@ -34,6 +34,8 @@ namespace stoat {
         kGoodCaptures,
         kGenerateNonCaptures,
         kNonCaptures,
+        kGenerateDrops,
+        kDrops,
         kBadCaptures,
         kQsearchGenerateCaptures,
         kQsearchCaptures,
@@ -98,6 +100,8 @@ namespace stoat {
 
         [[nodiscard]] usize findNext();
 
+        void partialSort(i32 threshold);
+
         template <bool kSort = true>
         [[nodiscard]] inline Move selectNext(auto predicate) {
             while (m_idx < m_end) {
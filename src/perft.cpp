@@ -18,66 +18,196 @@
 
 #include "perft.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "movegen.h"
+#include "util/perf_counters.h"
 #include "util/timer.h"
 
 namespace stoat {
     namespace {
-        usize doPerft(const Position& pos, i32 depth) {
+        // lockless: each entry's check word is the key xored with its data, so
+        // an entry torn by two threads writing at once fails verification
+        class PerftTable {
+        public:
+            explicit PerftTable(usize mib) :
+                    m_entryCount{mib * 1024 * 1024 / sizeof(Entry)},
+                    m_entries{std::make_unique<Entry[]>(m_entryCount)} {}
+
+            [[nodiscard]] inline bool probe(u64 key, i32 depth, usize& count) const {
+                const auto& entry = m_entries[index(key)];
+
+                const auto check = entry.check.load(std::memory_order::relaxed);
+                const auto data = entry.data.load(std::memory_order::relaxed);
+
+                if ((check ^ data) != key || static_cast<i32>(data & kDepthMask) != depth) {
+                    return false;
+                }
+
+                count = static_cast<usize>(data >> kDepthBits);
+                return true;
+            }
+
+            inline void store(u64 key, i32 depth, usize count) {
+                auto& entry = m_entries[index(key)];
+
+                const auto data = (static_cast<u64>(count) << kDepthBits) | static_cast<u64>(depth);
+
+                entry.check.store(key ^ data, std::memory_order::relaxed);
+                entry.data.store(data, std::memory_order::relaxed);
+            }
+
+        private:
+            static constexpr u32 kDepthBits = 8;
+            static constexpr u64 kDepthMask = (u64{1} << kDepthBits) - 1;
+
+            struct Entry {
+                std::atomic<u64> check{};
+                std::atomic<u64> data{};
+            };
+
+            [[nodiscard]] inline usize index(u64 key) const {
+                return static_cast<usize>((static_cast<u128>(key) * static_cast<u128>(m_entryCount)) >> 64);
+            }
+
+            usize m_entryCount;
+            std::unique_ptr<Entry[]> m_entries;
+        };
+
+        usize doPerft(const Position& pos, i32 depth, PerftTable* table) {
             if (depth <= 0) {
                 return 1;
             }
 
-            movegen::MoveList moves{};
-            movegen::generateAll(moves, pos);
+            // bulk counting, leaves are never made
+            if (depth == 1) {
+                movegen::MoveList moves{};
+                movegen::generateLegal(moves, pos);
+                return moves.size();
+            }
 
             usize total{};
 
+            // before generation, so that hits skip it entirely
+            if (table && table->probe(pos.key(), depth, total)) {
+                return total;
+            }
+
+            movegen::MoveList moves{};
+            movegen::generateLegal(moves, pos);
+
             for (const auto move : moves) {
-                if (!pos.isLegal(move)) {
-                    continue;
-                }
+                const auto newPos = pos.applyMove(move);
+                total += doPerft(newPos, depth - 1, table);
+            }
 
-                if (depth == 1) {
-                    ++total;
-                } else {
-                    const auto newPos = pos.applyMove(move);
-                    total += doPerft(newPos, depth - 1);
-                }
+            if (table) {
+                table->store(pos.key(), depth, total);
             }
 
             return total;
         }
+
+        // counts below each legal root move, in generation order
+        std::vector<std::pair<Move, usize>> perftRoot(const Position& pos, i32 depth, u32 threads, usize hashMib) {
+            std::vector<std::pair<Move, usize>> results{};
+
+            movegen::MoveList moves{};
+            movegen::generateLegal(moves, pos);
+
+            for (const auto move : moves) {
+                results.emplace_back(move, 0);
+            }
+
+            std::unique_ptr<PerftTable> table{};
+
+            // pointless for depth 2 and below, as depth 1 is bulk counted anyway
+            if (hashMib > 0 && depth > 2) {
+                table = std::make_unique<PerftTable>(hashMib);
+            }
+
+            std::atomic<usize> nextMove{0};
+
+            const auto worker = [&] {
+                while (true) {
+                    const auto idx = nextMove.fetch_add(1, std::memory_order::relaxed);
+
+                    if (idx >= results.size()) {
+                        break;
+                    }
+
+                    auto& [move, count] = results[idx];
+                    count = doPerft(pos.applyMove(move), depth - 1, table.get());
+                }
+            };
+
+            threads = std::clamp<u32>(threads, 1, std::max<usize>(results.size(), 1));
+
+            std::vector<std::thread> helpers{};
+            helpers.reserve(threads - 1);
+
+            for (u32 i = 1; i < threads; ++i) {
+                helpers.emplace_back(worker);
+            }
+
+            worker();
+
+            for (auto& helper : helpers) {
+                helper.join();
+            }
+
+            return results;
+        }
     } // namespace
 
-    void splitPerft(const Position& pos, i32 depth) {
+    usize perft(const Position& pos, i32 depth, u32 threads, usize hashMib) {
+        if (depth <= 0) {
+            return 1;
+        }
+
+        usize total{};
+
+        for (const auto& [move, count] : perftRoot(pos, depth, threads, hashMib)) {
+            total += count;
+        }
+
+        return total;
+    }
+
+    void splitPerft(const Position& pos, i32 depth, u32 threads, usize hashMib) {
         if (depth < 1) {
             depth = 1;
         }
 
+        // opened before any helper threads are started, so that they are counted too
+        util::PerfCounters counters{};
+
         const auto start = util::Instant::now();
+        counters.start();
 
-        movegen::MoveList moves{};
-        movegen::generateAll(moves, pos);
+        const auto results = perftRoot(pos, depth, threads, hashMib);
 
-        usize total{};
+        counters.stop();
 
-        for (const auto move : moves) {
-            if (!pos.isLegal(move)) {
-                continue;
-            }
+        const auto time = start.elapsed();
 
-            const auto newPos = pos.applyMove(move);
-            const auto value = doPerft(newPos, depth - 1);
+        usize total{};
 
-            total += value;
-            fmt::println("{}\t{}", move, value);
+        for (const auto& [move, count] : results) {
+            total += count;
+            fmt::println("{}\t{}", move, count);
         }
 
-        const auto nps = static_cast<usize>(static_cast<f64>(total) / start.elapsed());
+        const auto nps = static_cast<usize>(static_cast<f64>(total) / time);
 
         fmt::println("");
         fmt::println("total: {}", total);
         fmt::println("{} nps", nps);
+
+        counters.print(total);
     }
 } // namespace stoat
@@ -21,7 +21,30 @@
 #include "types.h"
 
 #include "position.h"
+#include "util/range.h"
 
 namespace stoat {
-    void splitPerft(const Position& pos, i32 depth);
-}
+    constexpr u32 kDefaultPerftThreads = 1;
+    constexpr util::Range<u32> kPerftThreadsRange{1, 2048};
+
+    // 0 disables the perft hash
+    constexpr usize kDefaultPerftHashMib = 0;
+    constexpr util::Range<usize> kPerftHashRange{0, 131072};
+
+    // counts leaf nodes, splitting the root moves between threads, and caching
+    // subtree counts by key and depth in a hash table shared by every thread
+    [[nodiscard]] usize perft(
+        const Position& pos,
+        i32 depth,
+        u32 threads = kDefaultPerftThreads,
+        usize hashMib = kDefaultPerftHashMib
+    );
+
+    // as perft, but also prints the count for each root move, timing and hardware counters
+    void splitPerft(
+        const Position& pos,
+        i32 depth,
+        u32 threads = kDefaultPerftThreads,
+        usize hashMib = kDefaultPerftHashMib
+    );
+} // namespace stoat
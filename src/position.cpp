@@ -24,7 +24,6 @@
 #include "attacks/attacks.h"
 #include "eval/nnue.h"
 #include "keys.h"
-#include "movegen.h"
 #include "rays.h"
 #include "util/parse.h"
 #include "util/split.h"
@@ -244,6 +243,14 @@ namespace stoat {
         m_mailbox.fill(Pieces::kNone);
     }
 
+    // pins and threats are derived state that may not have been computed yet
+    bool Position::operator==(const Position& other) const {
+        return m_colors == other.m_colors && m_pieces == other.m_pieces && m_mailbox == other.m_mailbox
+            && m_hands == other.m_hands && m_consecutiveChecks == other.m_consecutiveChecks && m_keys == other.m_keys
+            && m_checkers == other.m_checkers && m_kingSquares == other.m_kingSquares && m_stm == other.m_stm
+            && m_moveCount == other.m_moveCount;
+    }
+
     template <NnueUpdateAction kUpdateAction>
     Position Position::applyMove(Move move, eval::nnue::NnueState* nnueState) const {
         static constexpr bool kUpdateNnue = kUpdateAction != NnueUpdateAction::kNone;
@@ -527,16 +534,7 @@ namespace stoat {
                 const auto dropBb = Bitboard::fromSquare(move.to());
                 if (!(dropBb.shiftNorthRelative(stm) & pieceBb(PieceTypes::kKing, nstm)).empty()) {
                     // this pawn drop gives check - ensure it's not mate
-                    // slow and cursed, but rare
-                    const auto newPos = applyMove(move);
-
-                    assert(newPos.checkers().one());
-                    assert(newPos.checkers().getSquare(move.to()));
-
-                    movegen::MoveList newMoves{};
-                    movegen::generateAll(newMoves, newPos);
-
-                    return std::ranges::any_of(newMoves, [&](Move newMove) { return newPos.isLegal(newMove); });
+                    return !isPawnDropMate(move.to());
                 }
             }
 
@@ -545,15 +543,13 @@ namespace stoat {
         }
 
         if (pieceOn(move.from()).type() == PieceTypes::kKing) {
-            // remove the king to account for moving away from the checker
-            const auto kinglessOcc = occupancy() ^ pieceBb(PieceTypes::kKing, stm);
-            return !isAttacked(move.to(), nstm, kinglessOcc);
+            return !threats().getSquare(move.to());
         } else if (m_checkers.multiple()) {
             // multiple checks can only be evaded with a king move
             return false;
         }
 
-        if (m_pinned.getSquare(move.from())) {
+        if (pinned().getSquare(move.from())) {
             const auto pinRay = rayIntersecting(move.from(), stmKing);
             if (!pinRay.getSquare(move.to())) {
                 return false;
@@ -579,6 +575,44 @@ namespace stoat {
         return pieceOn(move.to()) != Pieces::kNone;
     }
 
+    bool Position::isPawnDropMate(Square sq) const {
+        const auto stm = this->stm();
+        const auto nstm = this->stm().flip();
+
+        const auto theirKing = kingSq(nstm);
+
+        assert(!occupancy().getSquare(sq));
+        assert(attacks::pawnAttacks(sq, stm).getSquare(theirKing));
+
+        // the opponent cannot already be in check, so the pawn is the only checker.
+        // a pawn only ever gives contact check, so it cannot be blocked
+        const auto occ = occupancy() | Bitboard::fromSquare(sq);
+
+        // king escapes, including capturing the pawn. the pawn only attacks the king's own
+        // square, so it does not need to be added to the attackers here
+        const auto kinglessOcc = occ ^ Bitboard::fromSquare(theirKing);
+
+        auto escapes = attacks::kingAttacks(theirKing) & ~colorBb(nstm);
+        while (!escapes.empty()) {
+            const auto to = escapes.popLsb();
+            if (!isAttacked(to, stm, kinglessOcc)) {
+                return false;
+            }
+        }
+
+        // captures of the pawn by anything other than the king, which must not expose the king.
+        // the pawn is no longer on the board afterwards, but the capturing piece blocks its square
+        auto captures = attackersTo(sq, nstm) & ~Bitboard::fromSquare(theirKing);
+        while (!captures.empty()) {
+            const auto from = captures.popLsb();
+            if (!isAttacked(theirKing, stm, occ ^ Bitboard::fromSquare(from))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     bool Position::isAttacked(Square sq, Color attacker, Bitboard occ) const {
         assert(sq);
         assert(attacker);
@@ -803,15 +837,16 @@ namespace stoat {
         assert(!pieceOn(sq));
 
         m_colors[piece.color().idx()] |= sq.bit();
-        m_pieces[piece.type().idx()] |= sq.bit();
-
-        m_mailbox[sq.idx()] = piece;
-
-        m_keys.flipPiece(piece, sq);
 
         if (piece.type() == PieceTypes::kKing) {
             m_kingSquares.squares[piece.color().idx()] = sq;
+        } else {
+            m_pieces[piece.type().idx()] |= sq.bit();
         }
+
+        m_mailbox[sq.idx()] = piece;
+
+        m_keys.flipPiece(piece, sq);
     }
 
     template <bool kUpdateNnue>
@@ -843,7 +878,6 @@ namespace stoat {
         }
 
         m_colors[piece.color().idx()] ^= from.bit() ^ to.bit();
-        m_pieces[piece.type().idx()] ^= from.bit() ^ to.bit();
 
         m_mailbox[from.idx()] = Pieces::kNone;
         m_mailbox[to.idx()] = piece;
@@ -855,6 +889,8 @@ namespace stoat {
             if (kUpdateNnue && eval::nnue::requiresRefresh(piece.color(), to, from)) {
                 nnueUpdates.setRefresh(piece.color());
             }
+        } else {
+            m_pieces[piece.type().idx()] ^= from.bit() ^ to.bit();
         }
 
         if constexpr (kUpdateNnue) {
@@ -930,13 +966,44 @@ namespace stoat {
 
     void Position::updateAttacks() {
         const auto stm = this->stm();
-        const auto nstm = this->stm().flip();
+        m_checkers = attackersTo(kingSq(stm), stm.flip());
 
-        m_checkers = attackersTo(kingSq(stm), nstm);
-        m_pinned = Bitboards::kEmpty;
+        // pins and threats are only needed once moves are generated or tested for legality,
+        // which many nodes never get to
+        m_pinsAndThreatsValid = false;
+    }
+
+    void Position::updatePinsAndThreats() const {
+        if (stm() == Colors::kBlack) {
+            updatePinsAndThreats<Colors::kBlack.raw()>();
+        } else {
+            updatePinsAndThreats<Colors::kWhite.raw()>();
+        }
+
+        m_pinsAndThreatsValid = true;
+    }
+
+    template <u8 kStm>
+    void Position::updatePinsAndThreats() const {
+        constexpr auto stm = Color::fromRaw(kStm);
+        constexpr auto nstm = stm.flip();
 
         const auto stmKing = kingSq(stm);
 
+        // remove the king so that squares it could step back into along a slider's line count as attacked
+        const auto kinglessOcc = occupancy() ^ Bitboard::fromSquare(stmKing);
+
+        const auto nstmPawns = pieceBb(PieceTypes::kPawn, nstm);
+        m_threats = nstmPawns.shiftNorthRelative(nstm);
+
+        auto nstmPieces = colorBb(nstm) ^ nstmPawns;
+        while (!nstmPieces.empty()) {
+            const auto sq = nstmPieces.popLsb();
+            m_threats |= attacks::pieceAttacks(pieceOn(sq).type(), sq, nstm, kinglessOcc);
+        }
+
+        m_pinned = Bitboards::kEmpty;
+
         const auto stmOcc = colorBb(stm);
         const auto nstmOcc = colorBb(nstm);
 
@@ -958,6 +1025,16 @@ namespace stoat {
     }
 
     void Position::regen() {
+        // kings have no bitboard of their own, so they are whatever is left
+        auto kings = occupancy();
+
+        for (const auto bb : m_pieces) {
+            kings &= ~bb;
+        }
+
+        m_kingSquares.squares[Colors::kBlack.idx()] = (kings & m_colors[Colors::kBlack.idx()]).lsb();
+        m_kingSquares.squares[Colors::kWhite.idx()] = (kings & m_colors[Colors::kWhite.idx()]).lsb();
+
         m_mailbox.fill(Pieces::kNone);
 
         for (u8 pieceIdx = 0; pieceIdx < Pieces::kCount; ++pieceIdx) {
@@ -971,9 +1048,6 @@ namespace stoat {
             }
         }
 
-        m_kingSquares.squares[Colors::kBlack.idx()] = pieceBb(PieceTypes::kKing, Colors::kBlack).lsb();
-        m_kingSquares.squares[Colors::kWhite.idx()] = pieceBb(PieceTypes::kKing, Colors::kWhite).lsb();
-
         regenKey();
         updateAttacks();
     }
@@ -989,7 +1063,6 @@ namespace stoat {
         pos.m_pieces[PieceTypes::kKnight.idx()] = Bitboard{U128(0x8200, 0x82)};
         pos.m_pieces[PieceTypes::kSilver.idx()] = Bitboard{U128(0x4400, 0x44)};
         pos.m_pieces[PieceTypes::kGold.idx()] = Bitboard{U128(0x2800, 0x28)};
-        pos.m_pieces[PieceTypes::kKing.idx()] = Bitboard{U128(0x1000, 0x10)};
         pos.m_pieces[PieceTypes::kBishop.idx()] = Bitboard{U128(0x40, 0x400)};
         pos.m_pieces[PieceTypes::kRook.idx()] = Bitboard{U128(0x1, 0x10000)};
 
@@ -1050,11 +1123,12 @@ namespace stoat {
             }
         }
 
-        if (const auto blackKingCount = pos.pieceBb(Pieces::kBlackKing).popcount(); blackKingCount != 1) {
+        // the king bitboards are derived from the last king placed, so count them on the board
+        if (const auto blackKingCount = std::ranges::count(pos.m_mailbox, Pieces::kBlackKing); blackKingCount != 1) {
             return util::err<SfenError>("black must have exactly 1 king");
         }
 
-        if (const auto whiteKingCount = pos.pieceBb(Pieces::kWhiteKing).popcount(); whiteKingCount != 1) {
+        if (const auto whiteKingCount = std::ranges::count(pos.m_mailbox, Pieces::kWhiteKing); whiteKingCount != 1) {
             return util::err<SfenError>("white must have exactly 1 king");
         }
 
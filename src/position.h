@@ -25,6 +25,7 @@
 #include <string>
 #include <string_view>
 
+#include "arch.h"
 #include "bitboard.h"
 #include "move.h"
 #include "util/result.h"
@@ -149,17 +150,28 @@ namespace stoat {
 
         [[nodiscard]] inline Bitboard pieceTypeBb(PieceType pt) const {
             assert(pt);
+
+            if (pt == PieceTypes::kKing) {
+                return Bitboard::fromSquareOrZero(m_kingSquares.squares[0])
+                     | Bitboard::fromSquareOrZero(m_kingSquares.squares[1]);
+            }
+
             return m_pieces[pt.idx()];
         }
 
         [[nodiscard]] inline Bitboard pieceBb(Piece piece) const {
             assert(piece);
-            return m_colors[piece.color().idx()] & m_pieces[piece.type().idx()];
+            return pieceBb(piece.type(), piece.color());
         }
 
         [[nodiscard]] inline Bitboard pieceBb(PieceType pt, Color c) const {
             assert(pt);
             assert(c);
+
+            if (pt == PieceTypes::kKing) {
+                return Bitboard::fromSquareOrZero(m_kingSquares.kingSq(c));
+            }
+
             return m_colors[c.idx()] & m_pieces[pt.idx()];
         }
 
@@ -196,9 +208,23 @@ namespace stoat {
         }
 
         [[nodiscard]] inline Bitboard pinned() const {
+            if (!m_pinsAndThreatsValid) {
+                updatePinsAndThreats();
+            }
+
             return m_pinned;
         }
 
+        // squares attacked by the side not to move. the king of the side to move does not
+        // block sliders, so the squares behind it on a checking line are included as well
+        [[nodiscard]] inline Bitboard threats() const {
+            if (!m_pinsAndThreatsValid) {
+                updatePinsAndThreats();
+            }
+
+            return m_threats;
+        }
+
         [[nodiscard]] inline Color stm() const {
             return m_stm;
         }
@@ -243,7 +269,7 @@ namespace stoat {
 
         void regenKey();
 
-        [[nodiscard]] bool operator==(const Position&) const = default;
+        [[nodiscard]] bool operator==(const Position& other) const;
 
         Position& operator=(const Position&) = default;
         Position& operator=(Position&&) = default;
@@ -256,25 +282,33 @@ namespace stoat {
         friend std::ostream& operator<<(std::ostream& stream, const Position& pos);
 
     private:
+        // members are ordered by decreasing alignment to avoid padding, as positions are copied on every move
         std::array<Bitboard, Colors::kCount> m_colors{};
-        std::array<Bitboard, PieceTypes::kCount> m_pieces{};
+        // all but kings, which are found from m_kingSquares
+        std::array<Bitboard, PieceTypes::kCount - 1> m_pieces{};
 
-        std::array<Piece, Squares::kCount> m_mailbox{};
+        Bitboard m_checkers{};
+
+        // computed on first use, see updateAttacks. not safe to share a position
+        // between threads until they have been computed
+        mutable Bitboard m_pinned{};
+        mutable Bitboard m_threats{};
+
+        PositionKeys m_keys{};
 
         std::array<Hand, Colors::kCount> m_hands{};
 
         std::array<u16, Colors::kCount> m_consecutiveChecks{};
 
-        PositionKeys m_keys{};
-
-        Bitboard m_checkers{};
-        Bitboard m_pinned{};
+        u16 m_moveCount{1};
 
         KingPair m_kingSquares{};
 
+        std::array<Piece, Squares::kCount> m_mailbox{};
+
         Color m_stm{Colors::kBlack};
 
-        u16 m_moveCount{1};
+        mutable bool m_pinsAndThreatsValid{};
 
         void addPiece(Square sq, Piece piece);
 
@@ -287,8 +321,20 @@ namespace stoat {
 
         void updateAttacks();
 
+        void updatePinsAndThreats() const;
+        template <u8 kStm>
+        void updatePinsAndThreats() const;
+
+        // whether dropping a pawn of the side to move on this square checkmates the opponent
+        [[nodiscard]] bool isPawnDropMate(Square sq) const;
+
         void regen();
     };
+
+    static_assert(PieceTypes::kKing.idx() == PieceTypes::kCount - 1);
+
+    // copied on every move - 416 bytes, down from 448 with a king bitboard and padding
+    static_assert(sizeof(Position) == 416);
 } // namespace stoat
 
 template <>
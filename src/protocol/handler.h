@@ -27,7 +27,9 @@
 #include <variant>
 #include <vector>
 
+#include "../cluster/coordinator.h"
 #include "../core.h"
+#include "../mate/solver.h"
 #include "../position.h"
 #include "../pv.h"
 #include "../search.h"
@@ -41,6 +43,8 @@ namespace stoat::protocol {
         std::vector<u64> keyHistory{};
 
         Searcher* searcher{};
+        mate::MateSolver* mateSolver{};
+        cluster::Coordinator* cluster{};
 
         u32 moveOverhead{kDefaultMoveOverhead};
     };
@@ -96,7 +100,8 @@ namespace stoat::protocol {
         // engine -> gui
         virtual void printSearchInfo(const SearchInfo& info) const = 0;
         virtual void printInfoString(std::string_view str) const = 0;
-        virtual void printBestMove(Move move) const = 0;
+        virtual void printBestMove(Move move, Move ponderMove) const = 0;
+        virtual void printMateResult(const mate::MateResult& result) const = 0;
         virtual void handleNoLegalMoves() const = 0;
         virtual bool handleEnteringKingsWin() const = 0;
     };
@@ -71,7 +71,7 @@ namespace stoat::protocol {
 
         printInfoString("no legal moves");
         printSearchInfo(info);
-        printBestMove(kNullMove);
+        printBestMove(kNullMove, kNullMove);
     }
 
     bool UciHandler::handleEnteringKingsWin() const {
@@ -79,6 +79,28 @@ namespace stoat::protocol {
         return false;
     }
 
+    void UciHandler::printMateResult(const mate::MateResult& result) const {
+        switch (result.status) {
+            case mate::MateStatus::kMate: {
+                fmt::print("info string mate");
+
+                for (usize i = 0; i < result.pv.length; ++i) {
+                    fmt::print(" ");
+                    printMove(result.pv.moves[i]);
+                }
+
+                fmt::println("");
+                break;
+            }
+            case mate::MateStatus::kNoMate:
+                printInfoString("no mate");
+                break;
+            case mate::MateStatus::kTimeout:
+                printInfoString("mate search timed out");
+                break;
+        }
+    }
+
     void UciHandler::printOptionName(std::string_view name) const {
         fmt::print("{}", name);
     }
@@ -297,8 +319,4 @@ namespace stoat::protocol {
     std::string_view UciHandler::wincToken() const {
         return "binc";
     }
-
-    void UciHandler::printGoMateResponse() const {
-        //
-    }
 } // namespace stoat::protocol
@@ -25,6 +25,7 @@
 #include "../eval/nnue.h"
 #include "../limit.h"
 #include "../perft.h"
+#include "../trace.h"
 #include "../ttable.h"
 #include "../util/parse.h"
 #include "common.h"
@@ -38,6 +39,7 @@ namespace stoat::protocol {
         REGISTER_HANDLER(position);
         REGISTER_HANDLER(go);
         REGISTER_HANDLER(stop);
+        REGISTER_HANDLER(ponderhit);
         REGISTER_HANDLER(setoption);
 
         REGISTER_HANDLER(d);
@@ -60,6 +62,15 @@ namespace stoat::protocol {
             tt::kTtSizeRange.max()
         );
 
+        fmt::print("option name ");
+        printOptionName("MateHash");
+        fmt::println(
+            " type spin default {} min {} max {}",
+            mate::kDefaultMateTtSizeMib,
+            mate::kMateTtSizeRange.min(),
+            mate::kMateTtSizeRange.max()
+        );
+
         fmt::print("option name ");
         printOptionName("Threads");
         fmt::println(
@@ -69,10 +80,27 @@ namespace stoat::protocol {
             kThreadCountRange.max()
         );
 
+        fmt::print("option name ");
+        printOptionName("MateThreads");
+        fmt::println(
+            " type spin default {} min {} max {}",
+            kDefaultMateThreadCount,
+            kMateThreadCountRange.min(),
+            kMateThreadCountRange.max()
+        );
+
         fmt::print("option name ");
         printOptionName("MultiPV");
         fmt::println(" type spin default {} min {} max {}", kDefaultMultiPv, kMultiPvRange.min(), kMultiPvRange.max());
 
+        fmt::print("option name ");
+        printOptionName("ParallelMultiPV");
+        fmt::println(" type check default false");
+
+        fmt::print("option name ");
+        printOptionName("ABDADA");
+        fmt::println(" type check default false");
+
         fmt::print("option name ");
         printOptionName("MoveOverhead");
         fmt::println(
@@ -82,10 +110,22 @@ namespace stoat::protocol {
             kMoveOverheadRange.max()
         );
 
+        fmt::print("option name ");
+        printOptionName("Ponder");
+        fmt::println(" type check default false");
+
         fmt::print("option name ");
         printOptionName("CuteChessWorkaround");
         fmt::println(" type check default false");
 
+        fmt::print("option name ");
+        printOptionName("ClusterWorkers");
+        fmt::println(" type string default <empty>");
+
+        fmt::print("option name ");
+        printOptionName("TraceFile");
+        fmt::println(" type string default <empty>");
+
         finishInitialInfo();
     }
 
@@ -95,6 +135,10 @@ namespace stoat::protocol {
         util::Instant startTime
     ) {
         if (command == "quit") {
+            if (trace::enabled()) {
+                trace::write();
+            }
+
             return CommandResult::kQuit;
         }
 
@@ -166,9 +210,15 @@ namespace stoat::protocol {
         fmt::println("info string {}", str);
     }
 
-    void UciLikeHandler::printBestMove(Move move) const {
+    void UciLikeHandler::printBestMove(Move move, Move ponderMove) const {
         fmt::print("bestmove ");
         printMove(move);
+
+        if (ponderMove) {
+            fmt::print(" ponder ");
+            printMove(ponderMove);
+        }
+
         fmt::println("");
     }
 
@@ -181,8 +231,12 @@ namespace stoat::protocol {
         m_cmdHandlers[std::string{command}] = std::move(handler);
     }
 
+    bool UciLikeHandler::isSearching() const {
+        return m_state.searcher->isSearching() || m_state.mateSolver->isSolving();
+    }
+
     void UciLikeHandler::handleNewGame() {
-        if (m_state.searcher->isSearching()) {
+        if (isSearching()) {
             fmt::println(stderr, "Still searching");
             return;
         }
@@ -191,7 +245,7 @@ namespace stoat::protocol {
     }
 
     void UciLikeHandler::handle_position(std::span<std::string_view> args, [[maybe_unused]] util::Instant startTime) {
-        if (m_state.searcher->isSearching()) {
+        if (isSearching()) {
             fmt::println(stderr, "Still searching");
             return;
         }
@@ -246,7 +300,7 @@ namespace stoat::protocol {
     }
 
     void UciLikeHandler::handle_go(std::span<std::string_view> args, util::Instant startTime) {
-        if (m_state.searcher->isSearching()) {
+        if (isSearching()) {
             fmt::println(stderr, "Still searching");
             return;
         }
@@ -254,6 +308,7 @@ namespace stoat::protocol {
         auto limiter = std::make_unique<limit::CompoundLimiter>();
 
         bool infinite = false;
+        bool ponder = false;
 
         auto maxDepth = kMaxDepth;
 
@@ -268,6 +323,8 @@ namespace stoat::protocol {
         for (i32 i = 0; i < args.size(); ++i) {
             if (args[i] == "infinite") {
                 infinite = true;
+            } else if (args[i] == "ponder") {
+                ponder = true;
             } else if (args[i] == "depth") {
                 if (++i == args.size()) {
                     fmt::println(stderr, "Missing depth");
@@ -385,8 +442,30 @@ namespace stoat::protocol {
                 byoyomiMs = std::max<i64>(byoyomiMs, 0);
                 byoyomi = static_cast<f64>(byoyomiMs) / 1000.0;
             } else if (args[i] == "mate") {
-                printInfoString("go mate not supported");
-                printGoMateResponse();
+                if (++i == args.size()) {
+                    fmt::println(stderr, "Missing mate time limit");
+                    return;
+                }
+
+                std::unique_ptr<limit::ISearchLimiter> mateLimiter{};
+
+                if (args[i] == "infinite") {
+                    mateLimiter = std::make_unique<limit::CompoundLimiter>();
+                } else {
+                    i64 maxTimeMs{};
+
+                    if (!util::tryParse(maxTimeMs, args[i])) {
+                        fmt::println(stderr, "Invalid mate time limit '{}'", args[i]);
+                        return;
+                    }
+
+                    maxTimeMs = std::max<i64>(maxTimeMs - m_state.moveOverhead, 1);
+
+                    const auto maxTimeSec = static_cast<f64>(maxTimeMs) / 1000.0;
+                    mateLimiter = std::make_unique<limit::MoveTimeLimiter>(startTime, maxTimeSec);
+                }
+
+                m_state.mateSolver->startSolve(m_state.pos, std::move(mateLimiter));
                 return;
             }
         }
@@ -406,20 +485,45 @@ namespace stoat::protocol {
             printInfoString("Warning: increment given but no time, ignoring");
         }
 
-        m_state.searcher
-            ->startSearch(m_state.pos, m_state.keyHistory, startTime, infinite, maxDepth, std::move(limiter));
+        if (m_state.cluster) {
+            m_state.cluster->prepareSearch();
+        }
+
+        const bool started = m_state.searcher->startSearch(
+            m_state.pos,
+            m_state.keyHistory,
+            startTime,
+            infinite,
+            ponder,
+            maxDepth,
+            std::move(limiter)
+        );
+
+        if (started && m_state.cluster) {
+            m_state.cluster->startSearch(m_state.pos, m_state.keyHistory);
+        }
     }
 
     void UciLikeHandler::handle_stop(std::span<std::string_view> args, [[maybe_unused]] util::Instant startTime) {
         if (m_state.searcher->isSearching()) {
             m_state.searcher->stop();
+        } else if (m_state.mateSolver->isSolving()) {
+            m_state.mateSolver->stop();
         } else {
             fmt::println(stderr, "Not searching");
         }
     }
 
-    void UciLikeHandler::handle_setoption(std::span<std::string_view> args, [[maybe_unused]] util::Instant startTime) {
+    void UciLikeHandler::handle_ponderhit([[maybe_unused]] std::span<std::string_view> args, util::Instant startTime) {
         if (m_state.searcher->isSearching()) {
+            m_state.searcher->ponderhit(startTime);
+        } else {
+            fmt::println(stderr, "Not searching");
+        }
+    }
+
+    void UciLikeHandler::handle_setoption(std::span<std::string_view> args, [[maybe_unused]] util::Instant startTime) {
+        if (isSearching()) {
             fmt::println(stderr, "Still searching");
             return;
         }
@@ -489,6 +593,14 @@ namespace stoat::protocol {
             } else {
                 fmt::println(stderr, "Invalid hash size '{}'", value);
             }
+        } else if (name == "matehash") {
+            if (const auto newHash = util::tryParse<usize>(value)) {
+                const auto size = mate::kMateTtSizeRange.clamp(*newHash);
+                m_state.mateSolver->setTtSize(size);
+                m_state.searcher->setMateTtSize(size);
+            } else {
+                fmt::println(stderr, "Invalid mate hash size '{}'", value);
+            }
         } else if (name == "threads") {
             if (const auto newThreadCount = util::tryParse<u32>(value)) {
                 const auto threadCount = kThreadCountRange.clamp(*newThreadCount);
@@ -496,6 +608,13 @@ namespace stoat::protocol {
             } else {
                 fmt::println(stderr, "Invalid thread count '{}'", value);
             }
+        } else if (name == "matethreads") {
+            if (const auto newMateThreadCount = util::tryParse<u32>(value)) {
+                const auto mateThreadCount = kMateThreadCountRange.clamp(*newMateThreadCount);
+                m_state.searcher->setMateThreadCount(mateThreadCount);
+            } else {
+                fmt::println(stderr, "Invalid mate thread count '{}'", value);
+            }
         } else if (name == "multipv") {
             if (const auto newMultiPv = util::tryParse<u32>(value)) {
                 const auto multiPv = kMultiPvRange.clamp(*newMultiPv);
@@ -503,6 +622,18 @@ namespace stoat::protocol {
             } else {
                 fmt::println(stderr, "Invalid multiPV count '{}'", value);
             }
+        } else if (name == "abdada") {
+            if (const auto newAbdada = util::tryParseBool(value)) {
+                m_state.searcher->setAbdada(*newAbdada);
+            } else {
+                fmt::println(stderr, "Invalid check value '{}'", value);
+            }
+        } else if (name == "parallelmultipv") {
+            if (const auto newParallelMultiPv = util::tryParseBool(value)) {
+                m_state.searcher->setParallelMultiPv(*newParallelMultiPv);
+            } else {
+                fmt::println(stderr, "Invalid check value '{}'", value);
+            }
         } else if (name == "moveoverhead") {
             if (const auto newMoveOverhead = util::tryParse<u32>(value)) {
                 const auto moveOverhead = kMoveOverheadRange.clamp(*newMoveOverhead);
@@ -510,6 +641,18 @@ namespace stoat::protocol {
             } else {
                 fmt::println(stderr, "Invalid move overhead '{}'", value);
             }
+        } else if (name == "ponder") {
+            if (const auto newPonder = util::tryParseBool(value)) {
+                m_state.searcher->setPonderEnabled(*newPonder);
+            } else {
+                fmt::println(stderr, "Invalid check value '{}'", value);
+            }
+        } else if (name == "clusterworkers") {
+            if (m_state.cluster) {
+                m_state.cluster->setWorkers(value == "<empty>" ? "" : value);
+            }
+        } else if (name == "tracefile") {
+            trace::setOutputFile(value == "<empty>" ? "" : value);
         } else if (name == "cutechessworkaround") {
             if (const auto newCcWorkaround = util::tryParseBool(value)) {
                 m_state.searcher->setCuteChessWorkaround(*newCcWorkaround);
@@ -557,9 +700,27 @@ namespace stoat::protocol {
             return;
         }
 
-        if (const auto depth = util::tryParse<i32>(args[0])) {
-            splitPerft(m_state.pos, *depth);
+        const auto depth = util::tryParse<i32>(args[0]);
+
+        if (!depth) {
+            fmt::println(stderr, "Invalid depth '{}'", args[0]);
+            return;
+        }
+
+        u32 threads = kDefaultPerftThreads;
+        usize hash = kDefaultPerftHashMib;
+
+        if (args.size() >= 2 && !util::tryParse(threads, args[1])) {
+            fmt::println(stderr, "Invalid thread count '{}'", args[1]);
+            return;
         }
+
+        if (args.size() >= 3 && !util::tryParse(hash, args[2])) {
+            fmt::println(stderr, "Invalid hash size '{}'", args[2]);
+            return;
+        }
+
+        splitPerft(m_state.pos, *depth, kPerftThreadsRange.clamp(threads), kPerftHashRange.clamp(hash));
     }
 
     void UciLikeHandler::handle_raweval(
@@ -48,7 +48,7 @@ namespace stoat::protocol {
 
         void printSearchInfo(const SearchInfo& info) const final;
         void printInfoString(std::string_view str) const final;
-        void printBestMove(Move move) const final;
+        void printBestMove(Move move, Move ponderMove) const final;
 
     protected:
         using CommandHandlerType = std::function<void(std::span<std::string_view>, util::Instant)>;
@@ -56,6 +56,8 @@ namespace stoat::protocol {
 
         void handleNewGame();
 
+        [[nodiscard]] bool isSearching() const;
+
         virtual void printOptionName(std::string_view name) const = 0;
         [[nodiscard]] virtual std::string transformOptionName(std::string_view name) const = 0;
 
@@ -80,8 +82,6 @@ namespace stoat::protocol {
         [[nodiscard]] virtual std::string_view bincToken() const = 0;
         [[nodiscard]] virtual std::string_view wincToken() const = 0;
 
-        virtual void printGoMateResponse() const = 0;
-
         EngineState& m_state;
 
     private:
@@ -90,6 +90,7 @@ namespace stoat::protocol {
         void handle_position(std::span<std::string_view> args, util::Instant startTime);
         void handle_go(std::span<std::string_view> args, util::Instant startTime);
         void handle_stop(std::span<std::string_view> args, util::Instant startTime);
+        void handle_ponderhit(std::span<std::string_view> args, util::Instant startTime);
         void handle_setoption(std::span<std::string_view> args, util::Instant startTime);
 
         // nonstandard
@@ -44,10 +44,33 @@ namespace stoat::protocol {
         return true;
     }
 
+    void UsiHandler::printMateResult(const mate::MateResult& result) const {
+        switch (result.status) {
+            case mate::MateStatus::kMate: {
+                fmt::print("checkmate");
+
+                for (usize i = 0; i < result.pv.length; ++i) {
+                    fmt::print(" ");
+                    printMove(result.pv.moves[i]);
+                }
+
+                fmt::println("");
+                break;
+            }
+            case mate::MateStatus::kNoMate:
+                fmt::println("checkmate nomate");
+                break;
+            case mate::MateStatus::kTimeout:
+                fmt::println("checkmate timeout");
+                break;
+        }
+    }
+
     void UsiHandler::printOptionName(std::string_view name) const {
         static constexpr std::array kFixedSemanticsOptions = {
             "Hash",
             "MultiPV",
+            "Ponder",
         };
 
         if (std::ranges::find(kFixedSemanticsOptions, name) != kFixedSemanticsOptions.end()) {
@@ -125,8 +148,4 @@ namespace stoat::protocol {
     std::string_view UsiHandler::wincToken() const {
         return "winc";
     }
-
-    void UsiHandler::printGoMateResponse() const {
-        fmt::println("checkmate notimplemented");
-    }
 } // namespace stoat::protocol
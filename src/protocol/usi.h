@@ -30,6 +30,7 @@ namespace stoat::protocol {
 
         void handleNoLegalMoves() const final;
         bool handleEnteringKingsWin() const final;
+        void printMateResult(const mate::MateResult& result) const final;
 
         void printOptionName(std::string_view name) const final;
         [[nodiscard]] std::string transformOptionName(std::string_view name) const final;
@@ -52,7 +53,5 @@ namespace stoat::protocol {
 
         [[nodiscard]] std::string_view bincToken() const final;
         [[nodiscard]] std::string_view wincToken() const final;
-
-        void printGoMateResponse() const final;
     };
 } // namespace stoat::protocol
@@ -24,16 +24,23 @@
 #include "core.h"
 #include "eval/eval.h"
 #include "history.h"
+#include "mate/mate1.h"
 #include "movepick.h"
 #include "protocol/handler.h"
 #include "see.h"
 #include "stats.h"
+#include "trace.h"
 #include "util/multi_array.h"
 
 namespace stoat {
     namespace {
         constexpr f64 kWideningReportDelay = 1.5;
 
+        constexpr i32 kAbdadaMinDepth = 4;
+
+        // bounds the queue of tt entries waiting to be sent to other processes
+        constexpr usize kMaxSharedTtEntries = 4096;
+
         constexpr usize kLmpTableSize = 32;
 
         constexpr auto kLmpTable = [] {
@@ -69,17 +76,6 @@ namespace stoat {
             return reductions;
         }();
 
-        void generateLegal(movegen::MoveList& dst, const Position& pos) {
-            movegen::MoveList generated{};
-            movegen::generateAll(generated, pos);
-
-            for (const auto move : generated) {
-                if (pos.isLegal(move)) {
-                    dst.push(move);
-                }
-            }
-        }
-
         [[nodiscard]] constexpr Score drawScore(usize nodes) {
             return 2 - static_cast<Score>(nodes % 4);
         }
@@ -116,6 +112,49 @@ namespace stoat {
 
             return false;
         }
+
+        // replaces a root move's line with one found elsewhere, and re-sorts
+        void injectLine(std::vector<RootMove>& rootMoves, Score score, const PvList& pv) {
+            auto rootMove = std::ranges::find_if(rootMoves, [&](const RootMove& rootMove) {
+                return rootMove.pv.moves[0] == pv.moves[0];
+            });
+
+            // the move may not be among the merged lines of a split search
+            if (rootMove == rootMoves.end()) {
+                rootMove = std::prev(rootMoves.end());
+            }
+
+            rootMove->score = score;
+            rootMove->displayScore = score;
+            rootMove->upperbound = false;
+            rootMove->lowerbound = false;
+            rootMove->seldepth = std::max(rootMove->seldepth, static_cast<i32>(pv.length));
+            rootMove->pv = pv;
+
+            std::ranges::stable_sort(rootMoves, [](const RootMove& a, const RootMove& b) {
+                return a.score > b.score;
+            });
+        }
+
+        // lets the mate solver run until the search it belongs to is stopped
+        class SearchStopLimiter final : public limit::ISearchLimiter {
+        public:
+            explicit SearchStopLimiter(const std::atomic_bool& stop) :
+                    m_stop{stop} {}
+
+            ~SearchStopLimiter() final = default;
+
+            [[nodiscard]] inline bool stopSoft(usize nodes) final {
+                return m_stop.load(std::memory_order::relaxed);
+            }
+
+            [[nodiscard]] inline bool stopHard(usize nodes) final {
+                return m_stop.load(std::memory_order::relaxed);
+            }
+
+        private:
+            const std::atomic_bool& m_stop;
+        };
     } // namespace
 
     Searcher::Searcher(usize ttSizeMb) :
@@ -142,6 +181,12 @@ namespace stoat {
 
     void Searcher::ensureReady() {
         m_ttable.finalize();
+
+        for (auto& thread : m_threads) {
+            if (thread.mateSolver) {
+                thread.mateSolver->ensureReady();
+            }
+        }
     }
 
     void Searcher::setThreadCount(u32 threadCount) {
@@ -171,6 +216,14 @@ namespace stoat {
             thread.id = threadId;
             thread.thread = std::thread{[this, &thread] { runThread(thread); }};
         }
+
+        updateMateSolvers();
+    }
+
+    void Searcher::setMateThreadCount(u32 mateThreadCount) {
+        assert(!isSearching());
+        m_targetMateThreads = mateThreadCount;
+        updateMateSolvers();
     }
 
     void Searcher::setTtSize(usize mib) {
@@ -178,31 +231,69 @@ namespace stoat {
         m_ttable.resize(mib);
     }
 
+    void Searcher::setMateTtSize(usize mib) {
+        assert(!isSearching());
+        m_mateTtSize = mib;
+        updateMateSolvers();
+    }
+
     void Searcher::setMultiPv(u32 multiPv) {
         assert(!isSearching());
         m_targetMultiPv = multiPv;
     }
 
+    void Searcher::setParallelMultiPv(bool enabled) {
+        assert(!isSearching());
+        m_parallelMultiPv = enabled;
+    }
+
+    void Searcher::setAbdada(bool enabled) {
+        assert(!isSearching());
+        m_abdada = enabled;
+    }
+
+    void Searcher::setTrackDuplicates(bool enabled) {
+        assert(!isSearching());
+        m_trackDuplicates = enabled;
+    }
+
     void Searcher::setCuteChessWorkaround(bool enabled) {
         assert(!isSearching());
         m_cuteChessWorkaround = enabled;
     }
 
+    void Searcher::setSilent(bool silent) {
+        assert(!isSearching());
+        m_silent = silent;
+    }
+
+    void Searcher::setPonderEnabled(bool enabled) {
+        assert(!isSearching());
+        m_ponderEnabled = enabled;
+    }
+
+    void Searcher::setTtShareDepth(i32 depth) {
+        assert(!isSearching());
+        m_ttShareDepth = depth;
+    }
+
     void Searcher::setLimiter(std::unique_ptr<limit::ISearchLimiter> limiter) {
         m_limiter = std::move(limiter);
     }
 
-    void Searcher::startSearch(
+    bool Searcher::startSearch(
         const Position& pos,
         std::span<const u64> keyHistory,
         util::Instant startTime,
         bool infinite,
+        bool ponder,
         i32 maxDepth,
-        std::unique_ptr<limit::ISearchLimiter> limiter
+        std::unique_ptr<limit::ISearchLimiter> limiter,
+        std::span<const Move> searchMoves
     ) {
         if (!limiter) {
             fmt::println(stderr, "Missing limiter");
-            return;
+            return false;
         }
 
         movegen::MoveList rootMoves{};
@@ -210,11 +301,25 @@ namespace stoat {
 
         if (status == RootStatus::kNoLegalMoves) {
             protocol::currHandler().handleNoLegalMoves();
-            return;
+            return false;
+        }
+
+        if (!searchMoves.empty()) {
+            movegen::MoveList filtered{};
+
+            for (const auto move : rootMoves) {
+                if (std::ranges::find(searchMoves, move) != searchMoves.end()) {
+                    filtered.push(move);
+                }
+            }
+
+            if (!filtered.empty()) {
+                rootMoves = filtered;
+            }
         }
 
         if (pos.isEnteringKingsWin() && protocol::currHandler().handleEnteringKingsWin()) {
-            return;
+            return false;
         }
 
         m_resetBarrier.arriveAndWait();
@@ -234,11 +339,24 @@ namespace stoat {
         m_infinite = infinite;
         m_limiter = std::move(limiter);
 
+        m_pondering = ponder;
+        m_ponderhit.store(false);
+
         m_rootMoveList = rootMoves;
         assert(!m_rootMoveList.empty());
 
         m_multiPv = std::min<u32>(m_targetMultiPv, m_rootMoveList.size());
 
+        m_useSearchingTable = (m_abdada || m_trackDuplicates) && m_threads.size() - mateThreadCount() > 1;
+
+        m_rootSplitThreads = 0;
+
+        if (const auto searchThreads = m_threads.size() - mateThreadCount();
+            m_parallelMultiPv && m_multiPv > 1 && searchThreads > 1)
+        {
+            m_rootSplitThreads = std::min<u32>(searchThreads, m_rootMoveList.size());
+        }
+
         for (auto& thread : m_threads) {
             thread.reset(pos, keyHistory);
             thread.maxDepth = maxDepth;
@@ -251,25 +369,114 @@ namespace stoat {
         m_stop.store(false);
         m_runningThreads.store(m_threads.size());
 
+        m_matePv.reset();
+        m_mateFound.store(false);
+
+        {
+            const std::unique_lock externalLineLock{m_externalLineMutex};
+            m_externalLines.clear();
+        }
+
+        {
+            const std::unique_lock sharedTtLock{m_sharedTtMutex};
+            m_sharedTtEntries.clear();
+        }
+
         m_searching = true;
 
         m_idleBarrier.arriveAndWait();
+
+        return true;
     }
 
     void Searcher::stop() {
+        trace::instant("stop");
+
         m_stop.store(true, std::memory_order::relaxed);
 
         std::unique_lock lock{m_stopMutex};
+
+        // wake the main thread if it's holding its bestmove
+        m_stopSignal.notify_all();
+
         if (m_runningThreads.load() > 0) {
             m_stopSignal.wait(lock, [this] { return m_runningThreads.load() == 0; });
         }
     }
 
+    void Searcher::ponderhit(util::Instant time) {
+        m_ponderhitTime = time;
+        m_ponderhit.store(true, std::memory_order::release);
+
+        const std::unique_lock lock{m_stopMutex};
+        m_stopSignal.notify_all();
+    }
+
+    void Searcher::takeSharedTtEntries(std::vector<tt::SharedEntry>& dst) {
+        dst.clear();
+
+        const std::unique_lock lock{m_sharedTtMutex};
+        std::swap(dst, m_sharedTtEntries);
+    }
+
+    void Searcher::importTtEntries(std::span<const tt::SharedEntry> entries) {
+        for (const auto& entry : entries) {
+            if (entry.depth < 0 || entry.depth > kMaxDepth || entry.ply < 0 || entry.ply > kMaxDepth) {
+                continue;
+            }
+
+            m_ttable.put(entry.key, entry.score, entry.move, entry.depth, entry.ply, entry.flag, entry.pv);
+        }
+    }
+
+    void Searcher::reportExternalLine(u32 source, i32 depth, Score score, const PvList& pv) {
+        const std::unique_lock lock{m_externalLineMutex};
+
+        if (source >= m_externalLines.size()) {
+            m_externalLines.resize(source + 1);
+        }
+
+        auto& line = m_externalLines[source];
+
+        line.depth = depth;
+        line.score = score;
+        line.pv = pv;
+    }
+
     ThreadData& Searcher::mainThread() {
         return m_threads[0];
     }
 
     void Searcher::runBenchSearch(BenchInfo& info, const Position& pos, i32 depth) {
+        if (m_threads.size() > 1) {
+            const auto startTime = util::Instant::now();
+
+            if (!startSearch(pos, {}, startTime, false, false, depth, std::make_unique<limit::CompoundLimiter>())) {
+                return;
+            }
+
+            {
+                std::unique_lock lock{m_stopMutex};
+                m_stopSignal.wait(lock, [this] { return m_runningThreads.load() == 0; });
+            }
+
+            // the final report is not part of the search
+            info.time = startTime.elapsed();
+
+            // the main thread holds the search mutex until it has finished reporting
+            {
+                std::unique_lock lock{m_searchMutex};
+                m_searchEndSignal.wait(lock, [this] { return !m_searching; });
+            }
+
+            for (const auto& thread : m_threads) {
+                info.nodes += thread.loadNodes();
+                info.duplicateNodes += thread.loadDuplicateNodes();
+            }
+
+            return;
+        }
+
         if (initRootMoves(m_rootMoveList, pos) == RootStatus::kNoLegalMoves) {
             protocol::currHandler().printInfoString("no legal moves");
             return;
@@ -280,7 +487,10 @@ namespace stoat {
         m_limiter = std::make_unique<limit::CompoundLimiter>();
 
         m_multiPv = 1;
+        m_rootSplitThreads = 0;
+        m_useSearchingTable = false;
         m_infinite = false;
+        m_pondering = false;
 
         auto& thread = m_threads[0];
 
@@ -291,6 +501,8 @@ namespace stoat {
         m_runningThreads.store(1);
         m_stop.store(false);
 
+        m_mateFound.store(false);
+
         m_startTime = util::Instant::now();
 
         runSearch(thread);
@@ -323,11 +535,16 @@ namespace stoat {
         m_silent = true;
 
         m_multiPv = 1;
+        m_rootSplitThreads = 0;
+        m_useSearchingTable = false;
         m_infinite = false;
+        m_pondering = false;
 
         m_stop.store(false);
         ++m_runningThreads;
 
+        m_mateFound.store(false);
+
         runSearch(thread);
 
         m_silent = false;
@@ -341,11 +558,13 @@ namespace stoat {
 
     Searcher::RootStatus Searcher::initRootMoves(movegen::MoveList& dst, const Position& pos) {
         dst.clear();
-        generateLegal(dst, pos);
+        movegen::generateLegal(dst, pos);
         return dst.empty() ? Searcher::RootStatus::kNoLegalMoves : Searcher::RootStatus::kGenerated;
     }
 
     void Searcher::runThread(ThreadData& thread) {
+        trace::setThreadName(fmt::format("search thread {}", thread.id));
+
         while (true) {
             m_resetBarrier.arriveAndWait();
             m_idleBarrier.arriveAndWait();
@@ -354,7 +573,11 @@ namespace stoat {
                 return;
             }
 
-            runSearch(thread);
+            if (isMateThread(thread)) {
+                runMateSearch(thread);
+            } else {
+                runSearch(thread);
+            }
         }
     }
 
@@ -369,25 +592,74 @@ namespace stoat {
         }
     }
 
+    void Searcher::updateMateSolvers() {
+        for (auto& thread : m_threads) {
+            if (!isMateThread(thread)) {
+                thread.mateSolver.reset();
+            } else if (thread.mateSolver) {
+                thread.mateSolver->setTtSize(m_mateTtSize);
+            } else {
+                thread.mateSolver = std::make_unique<mate::MateSolver>(m_mateTtSize);
+            }
+        }
+    }
+
+    void Searcher::waitForThreads() {
+        {
+            const std::unique_lock lock{m_stopMutex};
+            --m_runningThreads;
+            m_stopSignal.notify_all();
+        }
+
+        m_searchEndBarrier.arriveAndWait();
+    }
+
+    bool Searcher::limitsActive() {
+        if (!m_pondering) {
+            return true;
+        }
+
+        if (!m_ponderhit.load(std::memory_order::acquire)) {
+            return false;
+        }
+
+        m_limiter->restartClock(m_ponderhitTime);
+        m_pondering = false;
+
+        return true;
+    }
+
     void Searcher::runSearch(ThreadData& thread) {
         assert(!m_rootMoveList.empty());
 
+        const bool splitRoot = isRootSplitThread(thread);
+
         thread.rootMoves.clear();
         thread.rootMoves.reserve(m_rootMoveList.size());
 
-        for (const auto move : m_rootMoveList) {
+        for (u32 idx = 0; idx < m_rootMoveList.size(); ++idx) {
+            if (splitRoot && idx % m_rootSplitThreads != thread.id) {
+                continue;
+            }
+
             auto& rootMove = thread.rootMoves.emplace_back();
 
-            rootMove.pv.moves[0] = move;
+            rootMove.pv.moves[0] = m_rootMoveList[idx];
             rootMove.pv.length = 1;
         }
 
+        const auto multiPv = std::min<u32>(m_multiPv, thread.rootMoves.size());
+
         PvList rootPv{};
 
+        usize iterationStartNodes = 0;
+
         for (i32 depth = 1;; ++depth) {
             thread.rootDepth = depth;
 
-            for (thread.pvIdx = 0; thread.pvIdx < m_multiPv; ++thread.pvIdx) {
+            const trace::Scope iteration{"iteration", static_cast<f64>(depth)};
+
+            for (thread.pvIdx = 0; thread.pvIdx < multiPv; ++thread.pvIdx) {
                 thread.resetSeldepth();
 
                 i32 window = 20;
@@ -424,10 +696,16 @@ namespace stoat {
                         break;
                     }
 
-                    if (thread.isMainThread()) {
+                    trace::instant(
+                        score <= alpha ? "aspiration fail low" : "aspiration fail high",
+                        static_cast<f64>(rootDepth)
+                    );
+
+                    // a split thread's pvIdx is not the line's place in the merged list
+                    if (thread.isMainThread() && !splitRoot) {
                         const auto time = m_startTime.elapsed();
                         if (time >= kWideningReportDelay) {
-                            reportSingle(thread, thread.pvIdx, depth, time);
+                            reportSingle(thread.rootMoves[thread.pvIdx], thread.pvIdx, depth, time);
                         }
                     }
 
@@ -457,34 +735,70 @@ namespace stoat {
 
             thread.depthCompleted = depth;
 
+            if constexpr (stats::kProfileSearch) {
+                thread.profile.iterationNodes[depth] = thread.loadNodes() - iterationStartNodes;
+                iterationStartNodes = thread.loadNodes();
+            }
+
+            if (splitRoot) {
+                const std::unique_lock lock{m_splitMutex};
+                thread.splitLines.push_back({depth, {thread.rootMoves.begin(), thread.rootMoves.begin() + multiPv}});
+            }
+
             if (depth >= thread.maxDepth) {
                 break;
             }
 
             if (thread.isMainThread()) {
-                m_limiter->update(depth, thread.pvMove().pv.moves[0]);
+                i32 reportDepth{};
+                const auto& rootMoves = mergeRootMoves(thread, reportDepth);
+
+                m_limiter->update(depth, rootMoves[0].pv.moves[0]);
+
+                if (limitsActive() && m_limiter->stopSoft(thread.loadNodes())) {
+                    trace::instant("soft limit stop", static_cast<f64>(depth));
+                    break;
+                }
 
-                if (m_limiter->stopSoft(thread.loadNodes())) {
+                // no point searching on once a mate thread has proven a win
+                if (!m_infinite && !m_pondering && m_mateFound.load(std::memory_order::relaxed)) {
+                    trace::instant("mate found stop", static_cast<f64>(depth));
                     break;
                 }
 
-                report(thread, depth, m_startTime.elapsed());
+                report(rootMoves, reportDepth, m_startTime.elapsed());
             }
         }
 
-        const auto waitForThreads = [&] {
-            {
-                const std::unique_lock lock{m_stopMutex};
-                --m_runningThreads;
-                m_stopSignal.notify_all();
-            }
+        // the merged lines only reach the depth limit once every split thread has reached it too.
+        // the others signal this on finishing, as they stop at the same limit
+        if (thread.isMainThread() && splitRoot && !hasStopped() && thread.depthCompleted >= thread.maxDepth) {
+            const auto allCompleted = [&] {
+                const std::unique_lock lock{m_splitMutex};
 
-            m_searchEndBarrier.arriveAndWait();
-        };
+                return std::ranges::all_of(std::span{m_threads}.first(m_rootSplitThreads), [&](const auto& other) {
+                    return !other.splitLines.empty() && other.splitLines.back().depth >= thread.maxDepth;
+                });
+            };
+
+            std::unique_lock lock{m_stopMutex};
+            m_stopSignal.wait(lock, [&] { return hasStopped() || allCompleted(); });
+        }
+
+        // bestmove may not be sent during an infinite or ponder search until
+        // the gui tells us to stop (or, when pondering, that the move was played)
+        if (thread.isMainThread() && (m_infinite || m_pondering) && !hasStopped()) {
+            std::unique_lock lock{m_stopMutex};
+            m_stopSignal.wait(lock, [this] {
+                return hasStopped() || (!m_infinite && m_ponderhit.load(std::memory_order::acquire));
+            });
+        }
 
         if (thread.isMainThread()) {
             const std::unique_lock lock{m_searchMutex};
 
+            trace::instant("search end");
+
             m_stop.store(true);
             waitForThreads();
 
@@ -493,12 +807,74 @@ namespace stoat {
             m_ttable.age();
             stats::print();
 
+            if constexpr (stats::kProfileSearch) {
+                if (!m_silent) {
+                    stats::SearchProfile profile{};
+
+                    for (const auto& searchThread : m_threads) {
+                        profile += searchThread.profile;
+                    }
+
+                    stats::printProfile(profile);
+                }
+            }
+
+            if (trace::enabled()) {
+                trace::write();
+            }
+
             m_searching = false;
+            m_finishedSearches.fetch_add(1, std::memory_order::release);
+
+            m_searchEndSignal.notify_all();
         } else {
             waitForThreads();
         }
     }
 
+    void Searcher::runMateSearch(ThreadData& thread) {
+        assert(!thread.isMainThread());
+
+        assert(thread.mateSolver);
+
+        const auto mateThreads = mateThreadCount();
+        const auto mateThreadIdx = thread.id - (m_threads.size() - mateThreads);
+
+        // the attacker can only play checks, so split those between the mate threads
+        std::vector<Move> rootMoves{};
+        u32 checkIdx = 0;
+
+        for (const auto move : m_rootMoveList) {
+            if (!thread.rootPos.applyMove(move).isInCheck()) {
+                continue;
+            }
+
+            if (checkIdx++ % mateThreads == mateThreadIdx) {
+                rootMoves.push_back(move);
+            }
+        }
+
+        if (!rootMoves.empty()) {
+            thread.mateSolver->clear();
+
+            SearchStopLimiter limiter{m_stop};
+            const auto result = thread.mateSolver->solve(thread.rootPos, limiter, rootMoves);
+
+            thread.stats.nodes.fetch_add(result.nodes, std::memory_order::relaxed);
+
+            if (result.status == mate::MateStatus::kMate) {
+                const std::unique_lock lock{m_matePvMutex};
+
+                if (!m_mateFound.load() || result.pv.length < m_matePv.length) {
+                    m_matePv = result.pv;
+                    m_mateFound.store(true);
+                }
+            }
+        }
+
+        waitForThreads();
+    }
+
     template <bool kPvNode, bool kRootNode>
     Score Searcher::search(
         ThreadData& thread,
@@ -523,7 +899,8 @@ namespace stoat {
         }
 
         if (!kRootNode && thread.isMainThread() && thread.rootDepth > 1) {
-            if (m_limiter->stopHard(thread.loadNodes())) {
+            if (limitsActive() && m_limiter->stopHard(thread.loadNodes())) {
+                trace::instant("hard limit stop");
                 m_stop.store(true, std::memory_order::relaxed);
                 return 0;
             }
@@ -544,6 +921,10 @@ namespace stoat {
 
         thread.incNodes();
 
+        if constexpr (stats::kProfileSearch) {
+            thread.profile.searchNode(ply);
+        }
+
         if constexpr (kPvNode) {
             thread.updateSeldepth(ply + 1);
         }
@@ -562,11 +943,17 @@ namespace stoat {
         if (!curr.excluded) {
             ttHit = m_ttable.probe(ttEntry, pos.key(), ply);
 
-            if (!kPvNode && ttEntry.depth >= depth
-                && (ttEntry.flag == tt::Flag::kExact                                   //
-                    || ttEntry.flag == tt::Flag::kUpperBound && ttEntry.score <= alpha //
-                    || ttEntry.flag == tt::Flag::kLowerBound && ttEntry.score >= beta))
-            {
+            const bool ttCutoff = !kPvNode && ttEntry.depth >= depth
+                               && (ttEntry.flag == tt::Flag::kExact                                   //
+                                   || ttEntry.flag == tt::Flag::kUpperBound && ttEntry.score <= alpha //
+                                   || ttEntry.flag == tt::Flag::kLowerBound && ttEntry.score >= beta);
+
+            if constexpr (stats::kProfileSearch) {
+                thread.profile.ttHits.hit(ttHit);
+                thread.profile.ttCutoffs.hit(ttCutoff);
+            }
+
+            if (ttCutoff) {
                 return ttEntry.score;
             }
 
@@ -634,12 +1021,26 @@ namespace stoat {
                 const auto score =
                     -search(thread, newPos, curr.pv, depth - r, ply + 1, -beta, -beta + 1, !expectedCutnode);
 
+                if constexpr (stats::kProfileSearch) {
+                    thread.profile.nullMove.hit(score >= beta);
+                }
+
                 if (score >= beta) {
                     return score > kScoreWin ? beta : score;
                 }
             }
         }
 
+        // mates in 1 are cheap to find directly, and
+        // would otherwise cost a full expansion of this node
+        if (!kPvNode && !pos.isInCheck() && !curr.excluded) {
+            if (const auto mateMove = mate::findMateIn1(pos)) {
+                const auto score = kScoreMate - ply - 1;
+                m_ttable.put(pos.key(), score, mateMove, depth, ply, tt::Flag::kExact, ttPv);
+                return score;
+            }
+        }
+
         auto bestMove = kNullMove;
         auto bestScore = -kScoreInf;
 
@@ -650,9 +1051,28 @@ namespace stoat {
         util::StaticVector<Move, 64> capturesTried{};
         util::StaticVector<Move, 64> nonCapturesTried{};
 
+        // moves that another thread was already searching, tried after everything else
+        util::StaticVector<Move, 32> deferredMoves{};
+        usize deferredIdx = 0;
+        bool deferring = false;
+
+        const bool useSearchingTable = m_useSearchingTable && !kRootNode && depth >= kAbdadaMinDepth;
+
+        const auto nextMove = [&] {
+            if (!deferring) {
+                if (const auto move = generator.next()) {
+                    return move;
+                }
+
+                deferring = true;
+            }
+
+            return deferredIdx < deferredMoves.size() ? deferredMoves[deferredIdx++] : kNullMove;
+        };
+
         u32 legalMoves{};
 
-        while (const auto move = generator.next()) {
+        while (const auto move = nextMove()) {
             assert(pos.isPseudolegal(move));
 
             if (move == curr.excluded) {
@@ -663,11 +1083,10 @@ namespace stoat {
                 if (!thread.isLegalRootMove(move)) {
                     continue;
                 }
-                assert(pos.isLegal(move));
-            } else if (!pos.isLegal(move)) {
-                continue;
             }
 
+            assert(pos.isLegal(move));
+
             if (isUnlikelyMove(pos, move) && curr.staticEval - 500 <= alpha) {
                 continue;
             }
@@ -692,6 +1111,16 @@ namespace stoat {
                 }
             }
 
+            bool duplicate = false;
+
+            if (useSearchingTable && m_searchingTable.isSearching(pos.key(), move)) {
+                if (m_abdada && legalMoves > 0 && !deferring && deferredMoves.tryPush(move)) {
+                    continue;
+                }
+
+                duplicate = true;
+            }
+
             if constexpr (kPvNode) {
                 curr.pv.length = 0;
             }
@@ -711,6 +1140,10 @@ namespace stoat {
                     const auto score = search(thread, pos, curr.pv, sDepth, ply, sBeta - 1, sBeta, expectedCutnode);
                     curr.excluded = kNullMove;
 
+                    if constexpr (stats::kProfileSearch) {
+                        thread.profile.singular.hit(score < sBeta);
+                    }
+
                     if (score < sBeta) {
                         extension = 1;
                     } else if (sBeta >= beta) {
@@ -729,8 +1162,13 @@ namespace stoat {
 
             m_ttable.prefetch(pos.keyAfter(move));
 
+            const auto claim = useSearchingTable ? m_searchingTable.claim(pos.key(), move) : SearchingTable::Claim{};
+
+            // only count the outermost duplicated subtree
+            const bool countDuplicate = duplicate && !thread.inDuplicate;
+
             const auto [newPos, guard] = thread.applyMove(ply, pos, move);
-            const auto sennichite = newPos.testSennichite(m_cuteChessWorkaround, thread.keyHistory);
+            const auto sennichite = thread.testSennichite(newPos, m_cuteChessWorkaround);
 
             const bool givesCheck = newPos.isInCheck();
 
@@ -756,6 +1194,10 @@ namespace stoat {
 
             newDepth += extension;
 
+            if (countDuplicate) {
+                thread.inDuplicate = true;
+            }
+
             if (depth >= 2 && legalMoves >= 3 + 2 * kRootNode && !givesCheck
                 && generator.stage() >= MovegenStage::kNonCaptures)
             {
@@ -772,6 +1214,10 @@ namespace stoat {
                 score = -search(thread, newPos, curr.pv, reduced, ply + 1, -alpha - 1, -alpha, true);
                 curr.reduction = 0;
 
+                if constexpr (stats::kProfileSearch) {
+                    thread.profile.lmrResearches.hit(score > alpha && reduced < newDepth);
+                }
+
                 if (score > alpha && reduced < newDepth) {
                     score = -search(thread, newPos, curr.pv, newDepth, ply + 1, -alpha - 1, -alpha, !expectedCutnode);
                 }
@@ -784,6 +1230,11 @@ namespace stoat {
             }
 
         skipSearch:
+            if (countDuplicate) {
+                thread.inDuplicate = false;
+                thread.stats.duplicateNodes.fetch_add(thread.loadNodes() - prevNodes, std::memory_order::relaxed);
+            }
+
             if (hasStopped()) {
                 return 0;
             }
@@ -840,6 +1291,10 @@ namespace stoat {
             }
 
             if (score >= beta) {
+                if constexpr (stats::kProfileSearch) {
+                    thread.profile.failHigh(legalMoves);
+                }
+
                 ttFlag = tt::Flag::kLowerBound;
                 break;
             }
@@ -893,6 +1348,14 @@ namespace stoat {
 
             if (!kRootNode || thread.pvIdx == 0) {
                 m_ttable.put(pos.key(), bestScore, bestMove, depth, ply, ttFlag, ttPv);
+
+                if (m_ttShareDepth > 0 && depth >= m_ttShareDepth) {
+                    const std::unique_lock lock{m_sharedTtMutex};
+
+                    if (m_sharedTtEntries.size() < kMaxSharedTtEntries) {
+                        m_sharedTtEntries.push_back({pos.key(), bestScore, bestMove, depth, ply, ttFlag, ttPv});
+                    }
+                }
             }
         }
 
@@ -908,7 +1371,8 @@ namespace stoat {
         }
 
         if (thread.isMainThread() && thread.rootDepth > 1) {
-            if (m_limiter->stopHard(thread.loadNodes())) {
+            if (limitsActive() && m_limiter->stopHard(thread.loadNodes())) {
+                trace::instant("hard limit stop");
                 m_stop.store(true, std::memory_order::relaxed);
                 return 0;
             }
@@ -916,6 +1380,10 @@ namespace stoat {
 
         thread.incNodes();
 
+        if constexpr (stats::kProfileSearch) {
+            thread.profile.qsearchNode(ply);
+        }
+
         if constexpr (kPvNode) {
             thread.updateSeldepth(ply + 1);
         }
@@ -949,8 +1417,9 @@ namespace stoat {
 
         while (const auto move = generator.next()) {
             assert(pos.isPseudolegal(move));
+            assert(pos.isLegal(move));
 
-            if (!pos.isLegal(move) || isUnlikelyMove(pos, move)) {
+            if (isUnlikelyMove(pos, move)) {
                 continue;
             }
 
@@ -972,7 +1441,7 @@ namespace stoat {
             ++legalMoves;
 
             const auto [newPos, guard] = thread.applyMove(ply, pos, move);
-            const auto sennichite = newPos.testSennichite(m_cuteChessWorkaround, thread.keyHistory);
+            const auto sennichite = thread.testSennichite(newPos, m_cuteChessWorkaround);
 
             Score score;
 
@@ -1009,12 +1478,67 @@ namespace stoat {
         return bestScore;
     }
 
-    void Searcher::reportSingle(const ThreadData& bestThread, u32 pvIdx, i32 depth, f64 time) {
+    std::vector<RootMove>& Searcher::mergeRootMoves(ThreadData& mainThread, i32& depth) {
+        assert(mainThread.isMainThread());
+
+        depth = mainThread.depthCompleted;
+
+        if (m_rootSplitThreads == 0) {
+            return mainThread.rootMoves;
+        }
+
+        m_mergedRootMoves.clear();
+
+        {
+            const std::unique_lock lock{m_splitMutex};
+
+            const auto splitThreads = std::span{m_threads}.first(m_rootSplitThreads);
+
+            // scores from different depths are not comparable, so only merge
+            // lines from the deepest depth that every thread has completed
+            i32 mergeDepth = kMaxDepth;
+
+            for (const auto& thread : splitThreads) {
+                if (thread.splitLines.empty()) {
+                    // stopped before this thread completed a depth
+                    return mainThread.rootMoves;
+                }
+
+                mergeDepth = std::min(mergeDepth, thread.splitLines.back().depth);
+            }
+
+            for (auto& thread : splitThreads) {
+                // every thread publishes each depth in order, and none has been discarded below mergeDepth
+                std::erase_if(thread.splitLines, [&](const SplitLines& entry) { return entry.depth < mergeDepth; });
+
+                assert(!thread.splitLines.empty() && thread.splitLines.front().depth == mergeDepth);
+
+                const auto& lines = thread.splitLines.front().lines;
+                m_mergedRootMoves.insert(m_mergedRootMoves.end(), lines.begin(), lines.end());
+            }
+
+            depth = mergeDepth;
+        }
+
+        // each thread's lines are the best over its own share of the root moves,
+        // so the best lines overall must be among them
+        std::ranges::stable_sort(m_mergedRootMoves, [](const RootMove& a, const RootMove& b) {
+            return a.score > b.score;
+        });
+
+        if (m_mergedRootMoves.size() > m_multiPv) {
+            m_mergedRootMoves.resize(m_multiPv);
+        }
+
+        return m_mergedRootMoves;
+    }
+
+    void Searcher::reportSingle(const RootMove& move, u32 pvIdx, i32 depth, f64 time) {
         if (m_silent) {
             return;
         }
 
-        const auto& move = bestThread.rootMoves[pvIdx];
+        trace::instant("report", static_cast<f64>(depth));
 
         auto score = move.score == -kScoreInf ? move.displayScore : move.score;
         depth = move.score == -kScoreInf ? std::max(1, depth - 1) : depth;
@@ -1066,9 +1590,44 @@ namespace stoat {
         protocol::currHandler().printSearchInfo(info);
     }
 
-    void Searcher::report(const ThreadData& bestThread, i32 depth, f64 time) {
-        for (u32 pvIdx = 0; pvIdx < m_multiPv; ++pvIdx) {
-            reportSingle(bestThread, pvIdx, depth, time);
+    void Searcher::report(std::span<const RootMove> rootMoves, i32 depth, f64 time) {
+        const auto lines = std::min<u32>(m_multiPv, rootMoves.size());
+
+        for (u32 pvIdx = 0; pvIdx < lines; ++pvIdx) {
+            reportSingle(rootMoves[pvIdx], pvIdx, depth, time);
+        }
+    }
+
+    void Searcher::applyMatePv(std::vector<RootMove>& rootMoves) {
+        if (!m_mateFound.load()) {
+            return;
+        }
+
+        const std::unique_lock lock{m_matePvMutex};
+
+        const auto score = kScoreMate - static_cast<Score>(m_matePv.length);
+
+        if (rootMoves[0].score >= score) {
+            return;
+        }
+
+        injectLine(rootMoves, score, m_matePv);
+    }
+
+    void Searcher::applyExternalLines(std::vector<RootMove>& rootMoves, i32 depth) {
+        const std::unique_lock lock{m_externalLineMutex};
+
+        for (const auto& line : m_externalLines) {
+            if (line.pv.length == 0 || line.depth < depth || line.score <= rootMoves[0].score) {
+                continue;
+            }
+
+            // guard against a misbehaving source
+            if (std::ranges::find(m_rootMoveList, line.pv.moves[0]) == m_rootMoveList.end()) {
+                continue;
+            }
+
+            injectLine(rootMoves, line.score, line.pv);
         }
     }
 
@@ -1077,9 +1636,21 @@ namespace stoat {
             return;
         }
 
-        const auto& bestThread = m_threads[0];
+        trace::instant("final report");
+
+        auto& bestThread = m_threads[0];
+
+        i32 depth{};
+        auto& rootMoves = mergeRootMoves(bestThread, depth);
+
+        applyMatePv(rootMoves);
+        applyExternalLines(rootMoves, depth);
+
+        const auto& pvMove = rootMoves[0];
+
+        const auto ponderMove = m_ponderEnabled && pvMove.pv.length >= 2 ? pvMove.pv.moves[1] : kNullMove;
 
-        report(bestThread, bestThread.depthCompleted, time);
-        protocol::currHandler().printBestMove(bestThread.pvMove().pv.moves[0]);
+        report(rootMoves, depth, time);
+        protocol::currHandler().printBestMove(pvMove.pv.moves[0], ponderMove);
     }
 } // namespace stoat
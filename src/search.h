@@ -20,6 +20,7 @@
 
 #include "types.h"
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <mutex>
@@ -27,6 +28,7 @@
 #include <utility>
 #include <vector>
 
+#include "abdada.h"
 #include "arch.h"
 #include "limit.h"
 #include "movegen.h"
@@ -41,11 +43,15 @@ namespace stoat {
     constexpr u32 kDefaultThreadCount = 1;
     constexpr util::Range<u32> kThreadCountRange{1, 2048};
 
+    constexpr u32 kDefaultMateThreadCount = 0;
+    constexpr util::Range<u32> kMateThreadCountRange{0, 2047};
+
     constexpr u32 kDefaultMultiPv = 1;
     constexpr util::Range<u32> kMultiPvRange{1, 600};
 
     struct BenchInfo {
         usize nodes{};
+        usize duplicateNodes{};
         f64 time{};
     };
 
@@ -58,9 +64,23 @@ namespace stoat {
         void ensureReady();
 
         void setThreadCount(u32 threadCount);
+        void setMateThreadCount(u32 mateThreadCount);
         void setTtSize(usize mib);
+        // size of each mate thread's own table
+        void setMateTtSize(usize mib);
         void setMultiPv(u32 multipv);
+        void setParallelMultiPv(bool enabled);
+        void setAbdada(bool enabled);
+        // keeps the searching table up to date even without abdada, for measuring duplicated work
+        void setTrackDuplicates(bool enabled);
         void setCuteChessWorkaround(bool enabled);
+        // suppresses all search output
+        void setSilent(bool silent);
+        void setPonderEnabled(bool enabled);
+
+        // tt writes at or above this depth are queued for other processes
+        // to pick up with takeSharedTtEntries, 0 to disable
+        void setTtShareDepth(i32 depth);
 
         void setLimiter(std::unique_ptr<limit::ISearchLimiter> limiter);
 
@@ -70,16 +90,30 @@ namespace stoat {
             return m_limiter.get();
         }
 
-        void startSearch(
+        // returns false if no search was started, e.g. when there are no legal moves
+        bool startSearch(
             const Position& pos,
             std::span<const u64> keyHistory,
             util::Instant startTime,
             bool infinite,
+            bool ponder,
             i32 maxDepth,
-            std::unique_ptr<limit::ISearchLimiter> limiter
+            std::unique_ptr<limit::ISearchLimiter> limiter,
+            std::span<const Move> searchMoves = {}
         );
         void stop();
 
+        void takeSharedTtEntries(std::vector<tt::SharedEntry>& dst);
+        void importTtEntries(std::span<const tt::SharedEntry> entries);
+
+        // a line found by some other searcher over the same root position, to be
+        // reported instead of our own if it is deeper and better. one line is kept per source
+        void reportExternalLine(u32 source, i32 depth, Score score, const PvList& pv);
+
+        // switches a ponder search over to a normal search,
+        // with time limits counting from the given instant
+        void ponderhit(util::Instant time);
+
         // THIS REFERENCE WILL BE DANGLING IF setThreads
         // IS CALLED OR THE SEARCHER IS DESTROYED
         [[nodiscard]] ThreadData& mainThread();
@@ -89,14 +123,24 @@ namespace stoat {
 
         [[nodiscard]] bool isSearching() const;
 
+        // incremented whenever a search ends, including bench and datagen searches
+        [[nodiscard]] inline u32 finishedSearches() const {
+            return m_finishedSearches.load(std::memory_order::acquire);
+        }
+
     private:
         std::vector<ThreadData> m_threads{};
 
         bool m_silent{};
         bool m_cuteChessWorkaround{};
+        bool m_ponderEnabled{};
 
         mutable std::mutex m_searchMutex{};
         bool m_searching{};
+        // signalled when m_searching is cleared
+        std::condition_variable m_searchEndSignal{};
+
+        std::atomic<u32> m_finishedSearches{};
 
         util::Instant m_startTime{util::Instant::now()};
 
@@ -116,13 +160,60 @@ namespace stoat {
         bool m_infinite{};
         std::unique_ptr<limit::ISearchLimiter> m_limiter{};
 
+        // only touched by the main search thread after the search has started
+        bool m_pondering{};
+
+        std::atomic_bool m_ponderhit{};
+        util::Instant m_ponderhitTime{util::Instant::now()};
+
+        u32 m_targetMateThreads{kDefaultMateThreadCount};
+        usize m_mateTtSize{mate::kDefaultMateTtSizeMib};
+
+        // written once by whichever mate thread first proves a mate from the root
+        std::mutex m_matePvMutex{};
+        PvList m_matePv{};
+        std::atomic_bool m_mateFound{};
+
         u32 m_targetMultiPv{kDefaultMultiPv};
         u32 m_multiPv{};
 
+        bool m_parallelMultiPv{};
+
+        // when nonzero, the root moves are dealt out between this many search
+        // threads, each of which searches multipv lines over only its own share
+        u32 m_rootSplitThreads{};
+
+        std::mutex m_splitMutex{};
+
+        // main thread only
+        std::vector<RootMove> m_mergedRootMoves{};
+
         movegen::MoveList m_rootMoveList{};
 
         tt::TTable m_ttable;
 
+        bool m_abdada{};
+        bool m_trackDuplicates{};
+
+        // whether moves are being recorded in the searching table this search
+        bool m_useSearchingTable{};
+
+        SearchingTable m_searchingTable{};
+
+        i32 m_ttShareDepth{};
+
+        std::mutex m_sharedTtMutex{};
+        std::vector<tt::SharedEntry> m_sharedTtEntries{};
+
+        struct ExternalLine {
+            i32 depth{};
+            Score score{};
+            PvList pv{};
+        };
+
+        std::mutex m_externalLineMutex{};
+        std::vector<ExternalLine> m_externalLines{};
+
         enum class RootStatus {
             kNoLegalMoves = 0,
             kGenerated,
@@ -138,7 +229,30 @@ namespace stoat {
 
         void stopThreads();
 
+        // gives every mate thread a solver of the current size, and frees the others
+        void updateMateSolvers();
+
+        // signals that this thread has finished, then waits for the others
+        void waitForThreads();
+
+        // main thread only
+        [[nodiscard]] bool limitsActive();
+
+        // never includes the main thread
+        [[nodiscard]] inline u32 mateThreadCount() const {
+            return std::min<u32>(m_targetMateThreads, m_threads.size() - 1);
+        }
+
+        [[nodiscard]] inline bool isMateThread(const ThreadData& thread) const {
+            return thread.id >= m_threads.size() - mateThreadCount();
+        }
+
+        [[nodiscard]] inline bool isRootSplitThread(const ThreadData& thread) const {
+            return thread.id < m_rootSplitThreads;
+        }
+
         void runSearch(ThreadData& thread);
+        void runMateSearch(ThreadData& thread);
 
         template <bool kPvNode = false, bool kRootNode = false>
         Score search(
@@ -167,9 +281,20 @@ namespace stoat {
         template <bool kPvNode = false>
         Score qsearch(ThreadData& thread, const Position& pos, i32 ply, Score alpha, Score beta);
 
-        void reportSingle(const ThreadData& bestThread, u32 pvIdx, i32 depth, f64 time);
+        // main thread only - the lines of every root split thread at the deepest depth they
+        // have all completed, best first, or just the main thread's root moves if the root is
+        // not being split or some split thread has not completed a depth yet. depth is set
+        // to the depth the returned lines were completed at
+        [[nodiscard]] std::vector<RootMove>& mergeRootMoves(ThreadData& mainThread, i32& depth);
+
+        void reportSingle(const RootMove& move, u32 pvIdx, i32 depth, f64 time);
+
+        void report(std::span<const RootMove> rootMoves, i32 depth, f64 time);
+
+        // swaps in a mate proven by a mate thread, if the main search has not found one at least as short
+        void applyMatePv(std::vector<RootMove>& rootMoves);
+        void applyExternalLines(std::vector<RootMove>& rootMoves, i32 depth);
 
-        void report(const ThreadData& bestThread, i32 depth, f64 time);
         void finalReport(f64 time);
     };
 } // namespace stoat
@@ -97,6 +97,12 @@ namespace stoat::see {
         }
 
         const auto sq = move.to();
+
+        // a drop does not uncover anything, so an unattacked square cannot be recaptured on
+        if (move.isDrop() && !pos.threats().getSquare(sq)) {
+            return true;
+        }
+
         auto occ = pos.occupancy() ^ sq.bit();
 
         if (!move.isDrop()) {
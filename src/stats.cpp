@@ -18,43 +18,90 @@
 
 #include "stats.h"
 
-#include <atomic>
+#include <iterator>
 #include <limits>
-#include <utility>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
-#include "util/multi_array.h"
+#include <fmt/ranges.h>
 
 namespace stoat::stats {
     namespace {
-        constexpr usize kSlots = 32;
+        struct HistogramInfo {
+            std::string name;
+            i64 min;
+            i64 bucketWidth;
+        };
+
+        struct Registry {
+            std::mutex mutex{};
 
-        struct Range {
-            std::atomic<i64> min{std::numeric_limits<i64>::max()};
-            std::atomic<i64> max{std::numeric_limits<i64>::min()};
+            std::vector<std::string> counters{};
+            std::vector<HistogramInfo> histograms{};
+
+            // blocks are never freed, as their counts still need to be printed
+            // after their thread exits. they are handed to the next new thread instead
+            std::vector<std::unique_ptr<internal::ThreadStats>> blocks{};
+            std::vector<internal::ThreadStats*> freeBlocks{};
         };
 
-        util::MultiArray<std::atomic<u64>, kSlots, 2> s_conditionHits{};
-        util::MultiArray<Range, kSlots> s_ranges{};
-        util::MultiArray<std::pair<std::atomic<i64>, std::atomic<u64>>, kSlots> s_means{};
+        Registry& registry() {
+            static Registry s_registry{};
+            return s_registry;
+        }
+
+        struct BlockReleaser {
+            internal::ThreadStats* block{};
+
+            ~BlockReleaser() {
+                if (!block) {
+                    return;
+                }
+
+                auto& reg = registry();
+                const std::unique_lock lock{reg.mutex};
 
-        std::atomic_bool s_anyUsed{false};
+                reg.freeBlocks.push_back(block);
+                internal::t_stats = nullptr;
+            }
+        };
+
+        thread_local BlockReleaser t_releaser{};
 
         template <typename T>
-        inline void atomicMin(std::atomic<T>& v, T x) {
-            auto curr = v.load();
-            while (x < curr && v.compare_exchange_weak(curr, x)) {
-                //
+        [[nodiscard]] inline T load(const std::atomic<T>& cell) {
+            return cell.load(std::memory_order::relaxed);
+        }
+    } // namespace
+
+    namespace internal {
+        ThreadStats::ThreadStats() {
+            for (usize slot = 0; slot < kSlots; ++slot) {
+                rangeMins[slot].store(std::numeric_limits<i64>::max(), std::memory_order::relaxed);
+                rangeMaxes[slot].store(std::numeric_limits<i64>::min(), std::memory_order::relaxed);
             }
         }
 
-        template <typename T>
-        inline void atomicMax(std::atomic<T>& v, T x) {
-            auto curr = v.load();
-            while (x > curr && v.compare_exchange_weak(curr, x)) {
-                //
+        ThreadStats& registerThread() {
+            auto& reg = registry();
+            const std::unique_lock lock{reg.mutex};
+
+            ThreadStats* block;
+
+            if (!reg.freeBlocks.empty()) {
+                block = reg.freeBlocks.back();
+                reg.freeBlocks.pop_back();
+            } else {
+                block = reg.blocks.emplace_back(std::make_unique<ThreadStats>()).get();
             }
+
+            t_releaser.block = block;
+
+            return *block;
         }
-    } // namespace
+    } // namespace internal
 
     void conditionHit(bool condition, usize slot) {
         if (slot >= kSlots) {
@@ -62,9 +109,7 @@ namespace stoat::stats {
             return;
         }
 
-        ++s_conditionHits[slot][condition];
-
-        s_anyUsed = true;
+        internal::add<u64>(internal::threadStats().conditionHits[slot][condition], 1);
     }
 
     void range(i64 v, usize slot) {
@@ -73,10 +118,15 @@ namespace stoat::stats {
             return;
         }
 
-        atomicMin(s_ranges[slot].min, v);
-        atomicMax(s_ranges[slot].max, v);
+        auto& stats = internal::threadStats();
 
-        s_anyUsed = true;
+        if (v < load(stats.rangeMins[slot])) {
+            stats.rangeMins[slot].store(v, std::memory_order::relaxed);
+        }
+
+        if (v > load(stats.rangeMaxes[slot])) {
+            stats.rangeMaxes[slot].store(v, std::memory_order::relaxed);
+        }
     }
 
     void mean(i64 v, usize slot) {
@@ -85,20 +135,58 @@ namespace stoat::stats {
             return;
         }
 
-        s_means[slot].first += v;
-        ++s_means[slot].second;
+        auto& stats = internal::threadStats();
+
+        internal::add(stats.meanTotals[slot], v);
+        internal::add<u64>(stats.meanCounts[slot], 1);
+    }
+
+    Counter::Counter(std::string_view name) {
+        auto& reg = registry();
+        const std::unique_lock lock{reg.mutex};
+
+        if (reg.counters.size() >= kMaxCounters) {
+            fmt::println(stderr, "tried to register counter {} (max {})", name, kMaxCounters);
+            m_id = kMaxCounters;
+            return;
+        }
+
+        m_id = reg.counters.size();
+        reg.counters.emplace_back(name);
+    }
+
+    Histogram::Histogram(std::string_view name, i64 min, i64 bucketWidth) :
+            m_min{min}, m_bucketWidth{std::max<i64>(bucketWidth, 1)} {
+        auto& reg = registry();
+        const std::unique_lock lock{reg.mutex};
+
+        if (reg.histograms.size() >= kMaxHistograms) {
+            fmt::println(stderr, "tried to register histogram {} (max {})", name, kMaxHistograms);
+            m_id = kMaxHistograms;
+            return;
+        }
 
-        s_anyUsed = true;
+        m_id = reg.histograms.size();
+        reg.histograms.push_back({std::string{name}, m_min, m_bucketWidth});
     }
 
     void print() {
-        if (!s_anyUsed.load()) {
+        auto& reg = registry();
+        const std::unique_lock lock{reg.mutex};
+
+        // no thread has touched any statistic
+        if (reg.blocks.empty()) {
             return;
         }
 
         for (usize slot = 0; slot < kSlots; ++slot) {
-            const auto hits = s_conditionHits[slot][1].load();
-            const auto misses = s_conditionHits[slot][0].load();
+            u64 hits{};
+            u64 misses{};
+
+            for (const auto& block : reg.blocks) {
+                hits += load(block->conditionHits[slot][1]);
+                misses += load(block->conditionHits[slot][0]);
+            }
 
             if (hits == 0 && misses == 0) {
                 continue;
@@ -113,8 +201,13 @@ namespace stoat::stats {
         }
 
         for (usize slot = 0; slot < kSlots; ++slot) {
-            const auto min = s_ranges[slot].min.load();
-            const auto max = s_ranges[slot].max.load();
+            auto min = std::numeric_limits<i64>::max();
+            auto max = std::numeric_limits<i64>::min();
+
+            for (const auto& block : reg.blocks) {
+                min = std::min(min, load(block->rangeMins[slot]));
+                max = std::max(max, load(block->rangeMaxes[slot]));
+            }
 
             if (min == std::numeric_limits<i64>::max()) {
                 continue;
@@ -126,8 +219,13 @@ namespace stoat::stats {
         }
 
         for (usize slot = 0; slot < kSlots; ++slot) {
-            const auto total = s_means[slot].first.load();
-            const auto count = s_means[slot].second.load();
+            i64 total{};
+            u64 count{};
+
+            for (const auto& block : reg.blocks) {
+                total += load(block->meanTotals[slot]);
+                count += load(block->meanCounts[slot]);
+            }
 
             if (count == 0) {
                 continue;
@@ -140,5 +238,203 @@ namespace stoat::stats {
             fmt::println("    total: {}", total);
             fmt::println("    count: {}", count);
         }
+
+        for (usize id = 0; id < reg.counters.size(); ++id) {
+            u64 total{};
+
+            for (const auto& block : reg.blocks) {
+                total += load(block->counters[id]);
+            }
+
+            if (total == 0) {
+                continue;
+            }
+
+            fmt::println("counter {}: {}", reg.counters[id], total);
+        }
+
+        for (usize id = 0; id < reg.histograms.size(); ++id) {
+            const auto& info = reg.histograms[id];
+
+            std::array<u64, kHistogramBuckets> buckets{};
+            u64 total{};
+
+            for (const auto& block : reg.blocks) {
+                for (usize bucket = 0; bucket < kHistogramBuckets; ++bucket) {
+                    const auto count = load(block->histograms[id][bucket]);
+                    buckets[bucket] += count;
+                    total += count;
+                }
+            }
+
+            if (total == 0) {
+                continue;
+            }
+
+            fmt::println("histogram {}:", info.name);
+            fmt::println("    count: {}", total);
+
+            for (usize bucket = 0; bucket < kHistogramBuckets; ++bucket) {
+                if (buckets[bucket] == 0) {
+                    continue;
+                }
+
+                const auto lower = info.min + static_cast<i64>(bucket) * info.bucketWidth;
+                const auto share = static_cast<f64>(buckets[bucket]) / static_cast<f64>(total);
+
+                if (bucket == 0) {
+                    fmt::print("    <{:<10}", lower + info.bucketWidth);
+                } else if (bucket == kHistogramBuckets - 1) {
+                    fmt::print("    >={:<9}", lower);
+                } else {
+                    fmt::print("    {:<11}", lower);
+                }
+
+                fmt::println(" {:>12} ({:.3f}%)", buckets[bucket], share * 100);
+            }
+        }
+    }
+
+    void SearchProfile::clear() {
+        *this = SearchProfile{};
+    }
+
+    SearchProfile& SearchProfile::operator+=(const SearchProfile& other) {
+        const auto addArray = [](auto& dst, const auto& src) {
+            for (usize i = 0; i < dst.size(); ++i) {
+                dst[i] += src[i];
+            }
+        };
+
+        const auto addRate = [](Rate& dst, const Rate& src) {
+            dst.attempts += src.attempts;
+            dst.successes += src.successes;
+        };
+
+        addArray(plyNodes, other.plyNodes);
+        addArray(iterationNodes, other.iterationNodes);
+        addArray(failHighIndex, other.failHighIndex);
+
+        searchNodes += other.searchNodes;
+        qsearchNodes += other.qsearchNodes;
+
+        addRate(ttHits, other.ttHits);
+        addRate(ttCutoffs, other.ttCutoffs);
+        addRate(nullMove, other.nullMove);
+        addRate(lmrResearches, other.lmrResearches);
+        addRate(singular, other.singular);
+
+        return *this;
+    }
+
+    void printProfile(const SearchProfile& profile) {
+        const auto ratio = [](u64 a, u64 b) {
+            return b == 0 ? 0.0 : static_cast<f64>(a) / static_cast<f64>(b);
+        };
+
+        const auto rate = [&](const SearchProfile::Rate& r) {
+            return ratio(r.successes, r.attempts);
+        };
+
+        const auto totalNodes = profile.searchNodes + profile.qsearchNodes;
+
+        u64 totalFailHighs{};
+        for (const auto count : profile.failHighIndex) {
+            totalFailHighs += count;
+        }
+
+        usize maxPly = 0;
+        for (usize ply = 0; ply < profile.plyNodes.size(); ++ply) {
+            if (profile.plyNodes[ply] > 0) {
+                maxPly = ply;
+            }
+        }
+
+        i32 maxIteration = 0;
+        for (i32 depth = 1; depth < static_cast<i32>(profile.iterationNodes.size()); ++depth) {
+            if (profile.iterationNodes[depth] > 0) {
+                maxIteration = depth;
+            }
+        }
+
+        const auto ebf = [&](i32 depth) {
+            return ratio(profile.iterationNodes[depth], profile.iterationNodes[depth - 1]);
+        };
+
+        fmt::println("search profile:");
+        fmt::println("    nodes:            {}", totalNodes);
+        fmt::println("    qsearch share:    {:.2f}%", ratio(profile.qsearchNodes, totalNodes) * 100);
+        fmt::println("    tt hit rate:      {:.2f}%", rate(profile.ttHits) * 100);
+        fmt::println("    tt cutoff rate:   {:.2f}%", rate(profile.ttCutoffs) * 100);
+        fmt::println("    nmp success:      {:.2f}% of {}", rate(profile.nullMove) * 100, profile.nullMove.attempts);
+        fmt::println(
+            "    lmr re-searches:  {:.2f}% of {}",
+            rate(profile.lmrResearches) * 100,
+            profile.lmrResearches.attempts
+        );
+        fmt::println("    se extensions:    {:.2f}% of {}", rate(profile.singular) * 100, profile.singular.attempts);
+
+        fmt::println("    fail high index:");
+        for (usize idx = 0; idx < profile.failHighIndex.size(); ++idx) {
+            const bool last = idx == profile.failHighIndex.size() - 1;
+            fmt::println(
+                "        {:>3}{} {:>7.3f}%",
+                idx + 1,
+                last ? "+" : " ",
+                ratio(profile.failHighIndex[idx], totalFailHighs) * 100
+            );
+        }
+
+        fmt::println("    {:>5} {:>14}", "ply", "nodes");
+        for (usize ply = 0; ply <= maxPly; ++ply) {
+            fmt::println("    {:>5} {:>14}", ply, profile.plyNodes[ply]);
+        }
+
+        fmt::println("    {:>5} {:>14} {:>8}", "depth", "nodes", "ebf");
+        for (i32 depth = 1; depth <= maxIteration; ++depth) {
+            const auto depthEbf = depth > 1 ? ebf(depth) : 0.0;
+            fmt::println("    {:>5} {:>14} {:>8.3f}", depth, profile.iterationNodes[depth], depthEbf);
+        }
+
+        std::string json{};
+        auto itr = std::back_inserter(json);
+
+        const auto rateJson = [&](std::string_view name, const SearchProfile::Rate& r) {
+            fmt::format_to(itr, R"("{}":{{"attempts":{},"successes":{}}},)", name, r.attempts, r.successes);
+        };
+
+        fmt::format_to(
+            itr,
+            R"({{"nodes":{},"search_nodes":{},"qsearch_nodes":{},)",
+            totalNodes,
+            profile.searchNodes,
+            profile.qsearchNodes
+        );
+
+        fmt::format_to(
+            itr,
+            R"("tt_probes":{},"tt_hits":{},"tt_cutoffs":{},)",
+            profile.ttHits.attempts,
+            profile.ttHits.successes,
+            profile.ttCutoffs.successes
+        );
+
+        rateJson("null_move", profile.nullMove);
+        rateJson("lmr_research", profile.lmrResearches);
+        rateJson("singular_extension", profile.singular);
+
+        fmt::format_to(itr, R"("fail_high_index":[{}],)", fmt::join(profile.failHighIndex, ","));
+        fmt::format_to(
+            itr,
+            R"("ply_nodes":[{}],)",
+            fmt::join(profile.plyNodes.begin(), profile.plyNodes.begin() + maxPly + 1, ",")
+        );
+        fmt::format_to(
+            itr,
+            R"("iteration_nodes":[{}]}})",
+            fmt::join(profile.iterationNodes.begin() + 1, profile.iterationNodes.begin() + maxIteration + 1, ",")
+        );
+
+        fmt::println("profile json {}", json);
     }
 } // namespace stoat::stats
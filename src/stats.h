@@ -20,10 +20,164 @@
 
 #include "types.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <string_view>
+
+#include "core.h"
+
 namespace stoat::stats {
+    constexpr usize kSlots = 32;
+
+    constexpr usize kMaxCounters = 64;
+    constexpr usize kMaxHistograms = 16;
+    constexpr usize kHistogramBuckets = 64;
+
+#ifdef ST_STATS
+    constexpr bool kEnableStats = true;
+#else
+    constexpr bool kEnableStats = false;
+#endif
+
+    namespace internal {
+        // each thread only ever writes to its own block, so updates are plain
+        // relaxed load/store pairs rather than contended read-modify-writes
+        template <typename T>
+        inline void add(std::atomic<T>& cell, T v) {
+            cell.store(cell.load(std::memory_order::relaxed) + v, std::memory_order::relaxed);
+        }
+
+        struct ThreadStats {
+            ThreadStats();
+
+            std::array<std::array<std::atomic<u64>, 2>, kSlots> conditionHits{};
+            std::array<std::atomic<i64>, kSlots> rangeMins{};
+            std::array<std::atomic<i64>, kSlots> rangeMaxes{};
+            std::array<std::atomic<i64>, kSlots> meanTotals{};
+            std::array<std::atomic<u64>, kSlots> meanCounts{};
+
+            // the extra entry absorbs updates to metrics registered past the limit
+            std::array<std::atomic<u64>, kMaxCounters + 1> counters{};
+            std::array<std::array<std::atomic<u64>, kHistogramBuckets>, kMaxHistograms + 1> histograms{};
+        };
+
+        [[nodiscard]] ThreadStats& registerThread();
+
+        inline thread_local ThreadStats* t_stats = nullptr;
+
+        [[nodiscard]] inline ThreadStats& threadStats() {
+            if (!t_stats) [[unlikely]] {
+                t_stats = &registerThread();
+            }
+
+            return *t_stats;
+        }
+    } // namespace internal
+
     void conditionHit(bool condition, usize slot = 0);
     void range(i64 value, usize slot = 0);
     void mean(i64 value, usize slot = 0);
 
+    // named metrics are registered once, usually as a static, and then
+    // updated through per-thread storage that is only merged by print().
+    // updates compile to nothing without ST_STATS
+    class Counter {
+    public:
+        explicit Counter(std::string_view name);
+
+        inline void add(u64 v = 1) const {
+            if constexpr (!kEnableStats) {
+                return;
+            }
+
+            internal::add(internal::threadStats().counters[m_id], v);
+        }
+
+    private:
+        usize m_id;
+    };
+
+    class Histogram {
+    public:
+        // values below min fall into the first bucket, and values past the last bucket into the last
+        explicit Histogram(std::string_view name, i64 min = 0, i64 bucketWidth = 1);
+
+        inline void record(i64 value) const {
+            if constexpr (!kEnableStats) {
+                return;
+            }
+
+            const auto bucket = std::clamp<i64>((value - m_min) / m_bucketWidth, 0, kHistogramBuckets - 1);
+            internal::add<u64>(internal::threadStats().histograms[m_id][bucket], 1);
+        }
+
+    private:
+        usize m_id;
+
+        i64 m_min;
+        i64 m_bucketWidth;
+    };
+
     void print();
+
+#ifdef ST_PROFILE_SEARCH
+    constexpr bool kProfileSearch = true;
+#else
+    constexpr bool kProfileSearch = false;
+#endif
+
+    // search tree shape counters, only updated with ST_PROFILE_SEARCH.
+    // each thread keeps its own, and they are summed at the end of a search
+    struct SearchProfile {
+        static constexpr usize kFailHighBuckets = 16;
+
+        struct Rate {
+            u64 attempts{};
+            u64 successes{};
+
+            inline void hit(bool success) {
+                ++attempts;
+                successes += success;
+            }
+        };
+
+        std::array<u64, kMaxDepth + 1> plyNodes{};
+        // nodes spent on each completed iteration, by depth
+        std::array<u64, kMaxDepth + 1> iterationNodes{};
+        // 1-based index of the move that failed high, the last bucket also counts all later moves
+        std::array<u64, kFailHighBuckets> failHighIndex{};
+
+        u64 searchNodes{};
+        u64 qsearchNodes{};
+
+        Rate ttHits{};
+        Rate ttCutoffs{};
+        Rate nullMove{};
+        // reduced searches, and how many of them had to be searched again at full depth
+        Rate lmrResearches{};
+        // singular searches, and how many of them extended
+        Rate singular{};
+
+        inline void searchNode(i32 ply) {
+            ++plyNodes[ply];
+            ++searchNodes;
+        }
+
+        inline void qsearchNode(i32 ply) {
+            ++plyNodes[ply];
+            ++qsearchNodes;
+        }
+
+        inline void failHigh(u32 moveIdx) {
+            ++failHighIndex[std::min<usize>(moveIdx, kFailHighBuckets) - 1];
+        }
+
+        void clear();
+
+        SearchProfile& operator+=(const SearchProfile& other);
+    };
+
+    // prints a table, then the same data as a single line of json
+    void printProfile(const SearchProfile& profile);
 } // namespace stoat::stats
@@ -18,12 +18,8 @@
 
 #include "thread.h"
 
-#include <iterator>
-
 namespace stoat {
     ThreadData::ThreadData() {
-        keyHistory.reserve(1024);
-
         stack.resize(kMaxDepth + 1);
         conthist.resize(kMaxDepth + 1);
     }
@@ -31,20 +27,26 @@ namespace stoat {
     void ThreadData::reset(const Position& newRootPos, std::span<const u64> newKeyHistory) {
         rootPos = newRootPos;
 
-        keyHistory.clear();
-        keyHistory.reserve(newKeyHistory.size());
-
-        std::ranges::copy(newKeyHistory, std::back_inserter(keyHistory));
+        keyHistory.reset(newKeyHistory);
 
         stats.seldepth.store(0);
         stats.nodes.store(0);
+        stats.duplicateNodes.store(0);
+
+        inDuplicate = false;
+
+        if constexpr (stats::kProfileSearch) {
+            profile.clear();
+        }
+
+        splitLines.clear();
     }
 
     std::pair<Position, ThreadPosGuard<true>> ThreadData::applyMove(i32 ply, const Position& pos, Move move) {
         stack[ply].move = move;
         conthist[ply] = &history.contTable(pos, move);
 
-        keyHistory.push_back(pos.key());
+        keyHistory.push(pos.key());
 
         return std::pair<Position, ThreadPosGuard<true>>{
             std::piecewise_construct,
@@ -57,7 +59,7 @@ namespace stoat {
         stack[ply].move = kNullMove;
         conthist[ply] = nullptr;
 
-        keyHistory.push_back(pos.key());
+        keyHistory.push(pos.key());
 
         return std::pair<Position, ThreadPosGuard<false>>{
             std::piecewise_construct,
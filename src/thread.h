@@ -21,6 +21,7 @@
 #include "types.h"
 
 #include <atomic>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -28,8 +29,11 @@
 #include "correction.h"
 #include "eval/nnue.h"
 #include "history.h"
+#include "key_history.h"
+#include "mate/solver.h"
 #include "position.h"
 #include "pv.h"
+#include "stats.h"
 
 namespace stoat {
     struct SearchStats {
@@ -42,9 +46,13 @@ namespace stoat {
         std::atomic<i32> seldepth{};
         std::atomic<usize> nodes{};
 
+        // nodes searched below a move that another thread was already searching
+        std::atomic<usize> duplicateNodes{};
+
         SearchStats& operator=(const SearchStats& other) {
             seldepth.store(other.seldepth);
             nodes.store(other.nodes);
+            duplicateNodes.store(other.duplicateNodes);
 
             return *this;
         }
@@ -61,24 +69,29 @@ namespace stoat {
         PvList pv{};
     };
 
+    struct SplitLines {
+        i32 depth;
+        std::vector<RootMove> lines;
+    };
+
     template <bool kUpdateNnue>
     class ThreadPosGuard {
     public:
-        explicit ThreadPosGuard(std::vector<u64>& keyHistory, eval::nnue::NnueState& nnueState) :
+        explicit ThreadPosGuard(KeyHistory& keyHistory, eval::nnue::NnueState& nnueState) :
                 m_keyHistory{keyHistory}, m_nnueState{nnueState} {}
 
         ThreadPosGuard(const ThreadPosGuard&) = delete;
         ThreadPosGuard(ThreadPosGuard&&) = delete;
 
         inline ~ThreadPosGuard() {
-            m_keyHistory.pop_back();
+            m_keyHistory.pop();
             if constexpr (kUpdateNnue) {
                 m_nnueState.pop();
             }
         }
 
     private:
-        std::vector<u64>& m_keyHistory;
+        KeyHistory& m_keyHistory;
         eval::nnue::NnueState& m_nnueState;
     };
 
@@ -101,7 +114,7 @@ namespace stoat {
         bool datagen{false};
 
         Position rootPos{};
-        std::vector<u64> keyHistory{};
+        KeyHistory keyHistory{};
 
         SearchStats stats{};
 
@@ -116,9 +129,21 @@ namespace stoat {
         u32 pvIdx{};
         std::vector<RootMove> rootMoves{};
 
+        // lines completed over this thread's share of the root moves when multipv is split
+        // between threads, one entry per depth from the shallowest that some other split
+        // thread has not yet completed. guarded by the searcher
+        std::vector<SplitLines> splitLines{};
+
         std::vector<StackFrame> stack{};
         std::vector<ContinuationSubtable*> conthist{};
 
+        bool inDuplicate{};
+
+        stats::SearchProfile profile{};
+
+        // only allocated for threads that are assigned to mate search
+        std::unique_ptr<mate::MateSolver> mateSolver{};
+
         [[nodiscard]] inline u32 isMainThread() const {
             return id == 0;
         }
@@ -141,12 +166,25 @@ namespace stoat {
             return stats.nodes.load(std::memory_order::relaxed);
         }
 
+        [[nodiscard]] inline usize loadDuplicateNodes() const {
+            return stats.duplicateNodes.load(std::memory_order::relaxed);
+        }
+
         inline void incNodes() {
             stats.nodes.fetch_add(1, std::memory_order::relaxed);
         }
 
         void reset(const Position& newRootPos, std::span<const u64> newKeyHistory);
 
+        [[nodiscard]] inline SennichiteStatus testSennichite(const Position& pos, bool cuteChessWorkaround) const {
+            // the common case, a position that has not occurred before
+            if (!keyHistory.mayContain(pos.key())) {
+                return SennichiteStatus::kNone;
+            }
+
+            return pos.testSennichite(cuteChessWorkaround, keyHistory.keys());
+        }
+
         [[nodiscard]] std::pair<Position, ThreadPosGuard<true>> applyMove(i32 ply, const Position& pos, Move move);
         [[nodiscard]] std::pair<Position, ThreadPosGuard<false>> applyNullMove(i32 ply, const Position& pos);
 
@@ -0,0 +1,235 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "trace.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace stoat::trace {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        // per thread, about 1 MiB
+        constexpr usize kRingCapacity = 32768;
+
+        struct Event {
+            Clock::time_point time;
+            const char* name;
+            f64 value;
+            Phase phase;
+        };
+
+        // single producer, the owning thread. only read by write()
+        struct Ring {
+            u32 tid;
+            std::string threadName{};
+
+            std::atomic<u64> head{};
+            std::array<Event, kRingCapacity> events;
+        };
+
+        struct Registry {
+            std::mutex mutex{};
+
+            std::string path{};
+            Clock::time_point epoch{Clock::now()};
+
+            // kept after their thread exits so its events can still be written,
+            // and handed to the next new thread
+            std::vector<std::unique_ptr<Ring>> rings{};
+            std::vector<Ring*> freeRings{};
+        };
+
+        Registry& registry() {
+            static Registry s_registry{};
+            return s_registry;
+        }
+
+        thread_local std::string t_threadName{};
+        thread_local Ring* t_ring = nullptr;
+
+        struct RingReleaser {
+            ~RingReleaser() {
+                if (!t_ring) {
+                    return;
+                }
+
+                auto& reg = registry();
+                const std::unique_lock lock{reg.mutex};
+
+                reg.freeRings.push_back(t_ring);
+                t_ring = nullptr;
+            }
+        };
+
+        thread_local RingReleaser t_releaser{};
+
+        Ring& registerThread() {
+            auto& reg = registry();
+            const std::unique_lock lock{reg.mutex};
+
+            Ring* ring;
+
+            if (!reg.freeRings.empty()) {
+                ring = reg.freeRings.back();
+                reg.freeRings.pop_back();
+            } else {
+                ring = reg.rings.emplace_back(std::make_unique<Ring>()).get();
+                ring->tid = reg.rings.size();
+            }
+
+            ring->threadName = t_threadName.empty() ? fmt::format("thread {}", ring->tid) : t_threadName;
+
+            // make sure the releaser is constructed for this thread
+            static_cast<void>(&t_releaser);
+
+            return *ring;
+        }
+
+        [[nodiscard]] std::string_view phaseCode(Phase phase) {
+            switch (phase) {
+                case Phase::kBegin:
+                    return "B";
+                case Phase::kEnd:
+                    return "E";
+                case Phase::kInstant:
+                    return "i";
+                case Phase::kCounter:
+                    return "C";
+            }
+
+            return "i";
+        }
+    } // namespace
+
+    namespace internal {
+        void record(Phase phase, const char* name, f64 value) {
+            const auto time = Clock::now();
+
+            if (!t_ring) [[unlikely]] {
+                t_ring = &registerThread();
+            }
+
+            auto& ring = *t_ring;
+
+            const auto head = ring.head.load(std::memory_order::relaxed);
+            ring.events[head % kRingCapacity] = {time, name, value, phase};
+            ring.head.store(head + 1, std::memory_order::release);
+        }
+    } // namespace internal
+
+    void setOutputFile(std::string_view path) {
+        auto& reg = registry();
+        const std::unique_lock lock{reg.mutex};
+
+        reg.path = path;
+        internal::g_enabled.store(!path.empty(), std::memory_order::relaxed);
+    }
+
+    void setThreadName(std::string_view name) {
+        t_threadName = name;
+
+        if (t_ring) {
+            const std::unique_lock lock{registry().mutex};
+            t_ring->threadName = name;
+        }
+    }
+
+    void write() {
+        auto& reg = registry();
+        const std::unique_lock lock{reg.mutex};
+
+        if (reg.path.empty()) {
+            return;
+        }
+
+        auto* file = std::fopen(reg.path.c_str(), "w");
+
+        if (!file) {
+            fmt::println(stderr, "failed to open trace file {}", reg.path);
+            return;
+        }
+
+        fmt::print(file, R"({{"displayTimeUnit":"ms","traceEvents":[)");
+
+        bool first = true;
+
+        const auto separate = [&] {
+            if (!first) {
+                fmt::print(file, ",");
+            }
+
+            first = false;
+        };
+
+        for (const auto& ring : reg.rings) {
+            separate();
+            fmt::print(
+                file,
+                R"({{"ph":"M","name":"thread_name","pid":1,"tid":{},"args":{{"name":"{}"}}}})",
+                ring->tid,
+                ring->threadName
+            );
+
+            const auto head = ring->head.load(std::memory_order::acquire);
+            const auto begin = head > kRingCapacity ? head - kRingCapacity : 0;
+
+            for (auto idx = begin; idx < head; ++idx) {
+                const auto& event = ring->events[idx % kRingCapacity];
+
+                const auto us = std::chrono::duration<f64, std::micro>(event.time - reg.epoch).count();
+
+                separate();
+                fmt::print(
+                    file,
+                    R"({{"ph":"{}","name":"{}","pid":1,"tid":{},"ts":{:.3f})",
+                    phaseCode(event.phase),
+                    event.name,
+                    ring->tid,
+                    us
+                );
+
+                switch (event.phase) {
+                    case Phase::kInstant:
+                        fmt::print(file, R"(,"s":"t","args":{{"value":{}}}}})", event.value);
+                        break;
+                    case Phase::kBegin:
+                    case Phase::kCounter:
+                        fmt::print(file, R"(,"args":{{"value":{}}}}})", event.value);
+                        break;
+                    case Phase::kEnd:
+                        fmt::print(file, "}}");
+                        break;
+                }
+            }
+        }
+
+        fmt::println(file, "]}}");
+
+        std::fclose(file);
+    }
+} // namespace stoat::trace
@@ -0,0 +1,92 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <string_view>
+
+// timeline of search events, written as a chrome trace that perfetto can open.
+// disabled unless an output file is set, and then only records a handful of
+// events per iteration into a ring buffer owned by each thread
+namespace stoat::trace {
+    enum class Phase : u8 {
+        kBegin,
+        kEnd,
+        kInstant,
+        kCounter,
+    };
+
+    namespace internal {
+        inline std::atomic_bool g_enabled{false};
+
+        void record(Phase phase, const char* name, f64 value);
+    } // namespace internal
+
+    // empty to disable
+    void setOutputFile(std::string_view path);
+
+    // names the calling thread's track in the trace
+    void setThreadName(std::string_view name);
+
+    [[nodiscard]] inline bool enabled() {
+        return internal::g_enabled.load(std::memory_order::relaxed);
+    }
+
+    // names must be string literals, as only the pointer is stored
+    inline void instant(const char* name, f64 value = 0.0) {
+        if (enabled()) {
+            internal::record(Phase::kInstant, name, value);
+        }
+    }
+
+    inline void counter(const char* name, f64 value) {
+        if (enabled()) {
+            internal::record(Phase::kCounter, name, value);
+        }
+    }
+
+    class Scope {
+    public:
+        explicit Scope(const char* name, f64 value = 0.0) :
+                m_name{enabled() ? name : nullptr} {
+            if (m_name) {
+                internal::record(Phase::kBegin, m_name, value);
+            }
+        }
+
+        ~Scope() {
+            if (m_name) {
+                internal::record(Phase::kEnd, m_name, 0.0);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+
+    private:
+        const char* m_name;
+    };
+
+    // writes every buffered event to the output file, replacing it. events
+    // recorded while this runs may be missed, so call it while threads are idle
+    void write();
+} // namespace stoat::trace
@@ -43,6 +43,17 @@ namespace stoat::tt {
         bool pv;
     };
 
+    // a write that can be replayed into another table
+    struct SharedEntry {
+        u64 key;
+        Score score;
+        Move move;
+        i32 depth;
+        i32 ply;
+        Flag flag;
+        bool pv;
+    };
+
     class TTable {
     public:
         explicit TTable(usize mib);
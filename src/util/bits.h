@@ -83,6 +83,11 @@ namespace stoat::util {
         }
     }
 
+    [[nodiscard]] constexpr u128 byteswap(u128 v) {
+        const auto [high, low] = fromU128(v);
+        return toU128(__builtin_bswap64(low), __builtin_bswap64(high));
+    }
+
     [[nodiscard]] constexpr i32 popcount(u128 v) {
         const auto [high, low] = fromU128(v);
         return std::popcount(high) + std::popcount(low);
@@ -0,0 +1,296 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "json.h"
+
+#include <cstdlib>
+
+namespace stoat::util::json {
+    namespace {
+        constexpr usize kMaxNesting = 64;
+
+        class Parser {
+        public:
+            explicit Parser(std::string_view text) :
+                    m_text{text} {}
+
+            [[nodiscard]] std::optional<Value> parseDocument() {
+                auto value = parseValue(0);
+
+                skipWhitespace();
+
+                if (!value || m_pos != m_text.size()) {
+                    return {};
+                }
+
+                return value;
+            }
+
+        private:
+            std::string_view m_text;
+            usize m_pos{};
+
+            void skipWhitespace() {
+                while (m_pos < m_text.size()
+                       && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' || m_text[m_pos] == '\n'
+                           || m_text[m_pos] == '\r'))
+                {
+                    ++m_pos;
+                }
+            }
+
+            [[nodiscard]] bool consume(char c) {
+                skipWhitespace();
+
+                if (m_pos < m_text.size() && m_text[m_pos] == c) {
+                    ++m_pos;
+                    return true;
+                }
+
+                return false;
+            }
+
+            [[nodiscard]] bool consumeLiteral(std::string_view literal) {
+                if (m_text.substr(m_pos).starts_with(literal)) {
+                    m_pos += literal.size();
+                    return true;
+                }
+
+                return false;
+            }
+
+            [[nodiscard]] std::optional<Value> parseValue(usize depth) {
+                if (depth > kMaxNesting) {
+                    return {};
+                }
+
+                skipWhitespace();
+
+                if (m_pos >= m_text.size()) {
+                    return {};
+                }
+
+                switch (m_text[m_pos]) {
+                    case '{':
+                        return parseObject(depth);
+                    case '[':
+                        return parseArray(depth);
+                    case '"':
+                        if (auto str = parseString()) {
+                            return Value{std::move(*str)};
+                        }
+                        return {};
+                    default:
+                        break;
+                }
+
+                if (consumeLiteral("true")) {
+                    return Value{true};
+                } else if (consumeLiteral("false")) {
+                    return Value{false};
+                } else if (consumeLiteral("null")) {
+                    return Value{};
+                }
+
+                return parseNumber();
+            }
+
+            [[nodiscard]] std::optional<Value> parseNumber() {
+                constexpr std::string_view kNumberChars = "+-0123456789.eE";
+
+                const auto begin = m_pos;
+
+                while (m_pos < m_text.size() && kNumberChars.find(m_text[m_pos]) != std::string_view::npos) {
+                    ++m_pos;
+                }
+
+                // strtod rather than from_chars, which not every standard library supports for floats
+                const std::string str{m_text.substr(begin, m_pos - begin)};
+
+                char* end{};
+                const auto value = std::strtod(str.c_str(), &end);
+
+                if (str.empty() || end != str.c_str() + str.size()) {
+                    return {};
+                }
+
+                return Value{value};
+            }
+
+            // no unicode escapes, which this engine never writes
+            [[nodiscard]] std::optional<std::string> parseString() {
+                if (!consume('"')) {
+                    return {};
+                }
+
+                std::string result{};
+
+                while (m_pos < m_text.size()) {
+                    const auto c = m_text[m_pos++];
+
+                    if (c == '"') {
+                        return result;
+                    }
+
+                    if (c != '\\') {
+                        result.push_back(c);
+                        continue;
+                    }
+
+                    if (m_pos >= m_text.size()) {
+                        return {};
+                    }
+
+                    switch (const auto escaped = m_text[m_pos++]) {
+                        case 'n':
+                            result.push_back('\n');
+                            break;
+                        case 't':
+                            result.push_back('\t');
+                            break;
+                        case 'r':
+                            result.push_back('\r');
+                            break;
+                        case '"':
+                        case '\\':
+                        case '/':
+                            result.push_back(escaped);
+                            break;
+                        default:
+                            return {};
+                    }
+                }
+
+                return {};
+            }
+
+            [[nodiscard]] std::optional<Value> parseArray(usize depth) {
+                if (!consume('[')) {
+                    return {};
+                }
+
+                Value::Array array{};
+
+                if (consume(']')) {
+                    return Value{std::move(array)};
+                }
+
+                do {
+                    auto element = parseValue(depth + 1);
+
+                    if (!element) {
+                        return {};
+                    }
+
+                    array.push_back(std::move(*element));
+                } while (consume(','));
+
+                if (!consume(']')) {
+                    return {};
+                }
+
+                return Value{std::move(array)};
+            }
+
+            [[nodiscard]] std::optional<Value> parseObject(usize depth) {
+                if (!consume('{')) {
+                    return {};
+                }
+
+                Value::Object object{};
+
+                if (consume('}')) {
+                    return Value{std::move(object)};
+                }
+
+                do {
+                    skipWhitespace();
+
+                    auto key = parseString();
+
+                    if (!key || !consume(':')) {
+                        return {};
+                    }
+
+                    auto value = parseValue(depth + 1);
+
+                    if (!value) {
+                        return {};
+                    }
+
+                    object.emplace_back(std::move(*key), std::move(*value));
+                } while (consume(','));
+
+                if (!consume('}')) {
+                    return {};
+                }
+
+                return Value{std::move(object)};
+            }
+        };
+    } // namespace
+
+    std::optional<f64> Value::number() const {
+        if (const auto* value = std::get_if<f64>(&m_value)) {
+            return *value;
+        }
+
+        return {};
+    }
+
+    std::optional<bool> Value::boolean() const {
+        if (const auto* value = std::get_if<bool>(&m_value)) {
+            return *value;
+        }
+
+        return {};
+    }
+
+    const std::string* Value::string() const {
+        return std::get_if<std::string>(&m_value);
+    }
+
+    const Value::Array* Value::array() const {
+        return std::get_if<Array>(&m_value);
+    }
+
+    const Value::Object* Value::object() const {
+        return std::get_if<Object>(&m_value);
+    }
+
+    const Value* Value::find(std::string_view key) const {
+        const auto* obj = object();
+
+        if (!obj) {
+            return nullptr;
+        }
+
+        for (const auto& [k, v] : *obj) {
+            if (k == key) {
+                return &v;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::optional<Value> parse(std::string_view text) {
+        return Parser{text}.parseDocument();
+    }
+} // namespace stoat::util::json
@@ -0,0 +1,59 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../types.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// just enough json to read back files this engine writes
+namespace stoat::util::json {
+    class Value {
+    public:
+        using Array = std::vector<Value>;
+        using Object = std::vector<std::pair<std::string, Value>>;
+
+        Value() = default;
+
+        template <typename T>
+        explicit Value(T value) :
+                m_value{std::move(value)} {}
+
+        [[nodiscard]] std::optional<f64> number() const;
+        [[nodiscard]] std::optional<bool> boolean() const;
+
+        [[nodiscard]] const std::string* string() const;
+        [[nodiscard]] const Array* array() const;
+        [[nodiscard]] const Object* object() const;
+
+        // null if this is not an object, or has no such key
+        [[nodiscard]] const Value* find(std::string_view key) const;
+
+    private:
+        std::variant<std::monostate, bool, f64, std::string, Array, Object> m_value{};
+    };
+
+    [[nodiscard]] std::optional<Value> parse(std::string_view text);
+} // namespace stoat::util::json
@@ -0,0 +1,205 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace stoat::util {
+    namespace {
+        [[nodiscard]] constexpr const char* eventName(PerfEvent event) {
+            switch (event) {
+                case PerfEvent::kCycles:
+                    return "cycles";
+                case PerfEvent::kInstructions:
+                    return "instructions";
+                case PerfEvent::kL1dMisses:
+                    return "l1d misses";
+                case PerfEvent::kLlcMisses:
+                    return "llc misses";
+                case PerfEvent::kDtlbMisses:
+                    return "dtlb misses";
+                case PerfEvent::kBranchMisses:
+                    return "branch misses";
+                default:
+                    return "?";
+            }
+        }
+
+#ifdef __linux__
+        [[nodiscard]] constexpr u64 cacheMissConfig(u64 cache) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        }
+
+        [[nodiscard]] constexpr std::pair<u32, u64> eventConfig(PerfEvent event) {
+            switch (event) {
+                case PerfEvent::kCycles:
+                    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+                case PerfEvent::kInstructions:
+                    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+                case PerfEvent::kL1dMisses:
+                    return {PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_L1D)};
+                case PerfEvent::kLlcMisses:
+                    return {PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_LL)};
+                case PerfEvent::kDtlbMisses:
+                    return {PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_DTLB)};
+                case PerfEvent::kBranchMisses:
+                    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+                default:
+                    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+            }
+        }
+
+        [[nodiscard]] i32 openEvent(PerfEvent event) {
+            const auto [type, config] = eventConfig(event);
+
+            perf_event_attr attr{};
+
+            attr.size = sizeof(perf_event_attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.inherit = 1;
+            // allowed at perf_event_paranoid 2, the usual default
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            return static_cast<i32>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    } // namespace
+
+    PerfCounters::PerfCounters() {
+        m_fds.fill(-1);
+
+#ifdef __linux__
+        for (usize idx = 0; idx < kEventCount; ++idx) {
+            m_fds[idx] = openEvent(static_cast<PerfEvent>(idx));
+
+            if (m_fds[idx] < 0 && m_error == 0) {
+                m_error = errno;
+            }
+        }
+#endif
+    }
+
+    PerfCounters::~PerfCounters() {
+#ifdef __linux__
+        for (const auto fd : m_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    bool PerfCounters::available() const {
+        return std::ranges::any_of(m_fds, [](i32 fd) { return fd >= 0; });
+    }
+
+    void PerfCounters::start() {
+#ifdef __linux__
+        for (const auto fd : m_fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void PerfCounters::stop() {
+#ifdef __linux__
+        for (const auto fd : m_fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+#endif
+    }
+
+    std::optional<u64> PerfCounters::value(PerfEvent event) const {
+#ifdef __linux__
+        const auto fd = m_fds[static_cast<usize>(event)];
+
+        if (fd < 0) {
+            return {};
+        }
+
+        // value, time enabled, time running
+        std::array<u64, 3> values{};
+
+        if (read(fd, values.data(), sizeof(values)) != sizeof(values)) {
+            return {};
+        }
+
+        const auto [count, enabled, running] = values;
+
+        if (running == 0) {
+            return count == 0 ? std::optional<u64>{0} : std::nullopt;
+        }
+
+        return static_cast<u64>(static_cast<f64>(count) * static_cast<f64>(enabled) / static_cast<f64>(running));
+#else
+        return {};
+#endif
+    }
+
+    void PerfCounters::print(usize nodes) const {
+        if (!available()) {
+#ifdef __linux__
+            fmt::println("hardware counters unavailable: {}", std::strerror(m_error));
+#else
+            fmt::println("hardware counters unavailable on this platform");
+#endif
+            return;
+        }
+
+        const auto perNode = [&](u64 count) {
+            return static_cast<f64>(count) / static_cast<f64>(std::max<usize>(nodes, 1));
+        };
+
+        for (usize idx = 0; idx < kEventCount; ++idx) {
+            const auto event = static_cast<PerfEvent>(idx);
+
+            if (const auto count = value(event)) {
+                fmt::println("{:>14}: {:>16} ({:.2f}/node)", eventName(event), *count, perNode(*count));
+            } else {
+                fmt::println("{:>14}: unavailable", eventName(event));
+            }
+        }
+
+        const auto cycles = value(PerfEvent::kCycles);
+        const auto instructions = value(PerfEvent::kInstructions);
+
+        if (cycles && instructions && *cycles > 0) {
+            fmt::println("{:>14}: {:.3f}", "ipc", static_cast<f64>(*instructions) / static_cast<f64>(*cycles));
+        }
+    }
+} // namespace stoat::util
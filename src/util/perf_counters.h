@@ -0,0 +1,66 @@
+/*
+ * Stoat, a USI shogi engine
+ * Copyright (C) 2025 Ciekce
+ *
+ * Stoat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stoat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stoat. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "../types.h"
+
+#include <array>
+#include <optional>
+
+namespace stoat::util {
+    enum class PerfEvent : u8 {
+        kCycles,
+        kInstructions,
+        kL1dMisses,
+        kLlcMisses,
+        kDtlbMisses,
+        kBranchMisses,
+        kCount,
+    };
+
+    // hardware performance counters for the calling thread and any threads it creates
+    // afterwards, through perf_event_open on linux. each event is opened separately,
+    // and any the kernel or hardware refuses are just left out
+    class PerfCounters {
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters(PerfCounters&&) = delete;
+
+        [[nodiscard]] bool available() const;
+
+        void start();
+        void stop();
+
+        // total over every start/stop pair, scaled up if the counter was multiplexed
+        [[nodiscard]] std::optional<u64> value(PerfEvent event) const;
+
+        // counts per node, or a note on why there are none
+        void print(usize nodes) const;
+
+    private:
+        static constexpr auto kEventCount = static_cast<usize>(PerfEvent::kCount);
+
+        std::array<i32, kEventCount> m_fds{};
+        i32 m_error{};
+    };
+} // namespace stoat::util